@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BVH.hpp"
+#include "BenchmarkHelper.hpp"
+#include "Computations.hpp"
+#include "Parallel.hpp"
+
+namespace {
+// Closed sphere of side x side quads, 2 * side * side triangles
+Model generate_sphere(int side) {
+  Model model{0};
+  for (int i = 0; i <= side; ++i) {
+    const float theta = 3.14159265f * i / side;
+    for (int j = 0; j < side; ++j) {
+      const float phi = 2 * 3.14159265f * j / side;
+      model.positions.push_back({std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta), 1});
+    }
+  }
+
+  const auto index = [&](int i, int j) { return glm::ivec3{i * side + j % side, -1, -1}; };
+  for (int i = 0; i < side; ++i) {
+    for (int j = 0; j < side; ++j) {
+      model.triangular_faces.push_back({index(i, j), index(i + 1, j), index(i + 1, j + 1)});
+      model.triangular_faces.push_back({index(i, j), index(i + 1, j + 1), index(i, j + 1)});
+    }
+  }
+
+  return model;
+}
+}  // namespace
+
+// The side of the sphere can be passed as the first argument, the default gives about 10 million triangles
+int main(int argc, const char* argv[]) {
+  const int side          = argc > 1 ? std::atoi(argv[1]) : 2240;
+  const Model model       = generate_sphere(side);
+  const std::size_t faces = model.triangular_faces.size();
+
+  std::vector<std::size_t> thread_counts = {1};
+  if (resolve_thread_count(0) > 1) {
+    thread_counts.push_back(resolve_thread_count(0));
+  }
+
+  BVH bvh;
+  for (const std::size_t num_threads : thread_counts) {
+    const double seconds = measure_seconds([&] { bvh = BVH{model, num_threads}; }, 1);
+    report("BVH build, " + std::to_string(num_threads) + " threads", faces, "triangles", seconds);
+  }
+  std::cout << "  " << bvh.get_nodes().size() << " nodes\n";
+
+  std::mt19937 generator{5};
+  std::uniform_real_distribution<float> coordinate{-1.2f, 1.2f};
+  std::vector<glm::vec3> points(1000000);
+  for (auto& point : points) {
+    point = {coordinate(generator), coordinate(generator), coordinate(generator)};
+  }
+
+  std::size_t inside   = 0;
+  const double seconds = measure_seconds(
+      [&] {
+        inside = 0;
+        for (const auto& point : points) {
+          inside += is_point_inside_model(point, bvh);
+        }
+      },
+      1);
+  report("is_point_inside_model with the BVH", points.size(), "queries", seconds);
+
+  // Sorted along a Morton curve, traced in packets and split between threads
+  for (const std::size_t num_threads : thread_counts) {
+    std::size_t batch_inside   = 0;
+    const double batch_seconds = measure_seconds([&] {
+      const auto results = are_points_inside_model(points.data(), points.size(), bvh, num_threads);
+      batch_inside       = std::count(results.begin(), results.end(), 1);
+    });
+    report("are_points_inside_model, " + std::to_string(num_threads) + " threads",
+           points.size(),
+           "queries",
+           batch_seconds);
+
+    if (batch_inside != inside) {
+      std::cout << "  different results: " << batch_inside << " points inside\n";
+    }
+  }
+
+  // Dense grid over the same cube, like classifying voxels: neighbouring rays are parallel and close to each other
+  const int grid_side = 100;
+  std::vector<glm::vec3> grid;
+  grid.reserve(grid_side * grid_side * grid_side);
+  for (int x = 0; x < grid_side; ++x) {
+    for (int y = 0; y < grid_side; ++y) {
+      for (int z = 0; z < grid_side; ++z) {
+        grid.push_back(glm::vec3{x, y, z} * (2.4f / grid_side) - 1.2f);
+      }
+    }
+  }
+
+  std::size_t grid_inside   = 0;
+  const double grid_seconds = measure_seconds(
+      [&] {
+        grid_inside = 0;
+        for (const auto& point : grid) {
+          grid_inside += is_point_inside_model(point, bvh);
+        }
+      },
+      1);
+  report("grid, is_point_inside_model with the BVH", grid.size(), "queries", grid_seconds);
+
+  // Traced in packets of rays
+  for (const std::size_t num_threads : thread_counts) {
+    std::size_t batch_inside   = 0;
+    const double batch_seconds = measure_seconds([&] {
+      const auto results = are_points_inside_model(grid.data(), grid.size(), bvh, num_threads);
+      batch_inside       = std::count(results.begin(), results.end(), 1);
+    });
+    report("grid, are_points_inside_model, " + std::to_string(num_threads) + " threads",
+           grid.size(),
+           "queries",
+           batch_seconds);
+
+    if (batch_inside != grid_inside) {
+      std::cout << "  different results: " << batch_inside << " points inside\n";
+    }
+  }
+
+  // Every triangle is tested, so only a few queries
+  const std::size_t brute_force_queries = 5;
+  std::size_t brute_force_inside        = 0;
+  const double brute_force_seconds      = measure_seconds(
+      [&] {
+        brute_force_inside = 0;
+        for (std::size_t i = 0; i < brute_force_queries; ++i) {
+          brute_force_inside += is_point_inside_model(points[i], model);
+        }
+      },
+      1);
+  report("is_point_inside_model on every triangle", brute_force_queries, "queries", brute_force_seconds);
+
+  std::cout << inside << " of " << points.size() << " points inside\n";
+
+  return 0;
+}
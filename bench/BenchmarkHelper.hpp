@@ -0,0 +1,31 @@
+#ifndef BENCH_BENCHMARK_HELPER_HPP
+#define BENCH_BENCHMARK_HELPER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+// Runs function repeat times and returns the fastest run in seconds
+template <class Function>
+double measure_seconds(Function&& function, int repeat = 5) {
+  double best = 0;
+
+  for (int i = 0; i < repeat; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+  }
+
+  return best;
+}
+
+inline void report(const std::string& name, const std::size_t items, const std::string& unit, const double seconds) {
+  std::cout << name << ": " << items << " " << unit << " in " << seconds * 1000.0 << " ms, "
+            << static_cast<double>(items) / seconds << " " << unit << "/s\n";
+}
+
+#endif
@@ -0,0 +1,93 @@
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchmarkHelper.hpp"
+#include "FaceNormals.hpp"
+#include "Parallel.hpp"
+
+namespace {
+// Strip of random triangles, every vertex is shared by 3 of them like in a typical mesh
+Model generate_model(const std::size_t num_faces) {
+  std::mt19937 generator{42};
+  std::uniform_real_distribution<float> coordinate{-100.0f, 100.0f};
+
+  Model model{0};
+  model.positions.reserve(num_faces + 2);
+  model.triangular_faces.reserve(num_faces);
+
+  for (std::size_t i = 0; i < num_faces + 2; ++i) {
+    model.positions.push_back({coordinate(generator), coordinate(generator), coordinate(generator), 1});
+  }
+  for (int i = 0; static_cast<std::size_t>(i) < num_faces; ++i) {
+    model.triangular_faces.push_back({glm::ivec3{i, -1, -1}, glm::ivec3{i + 1, -1, -1}, glm::ivec3{i + 2, -1, -1}});
+  }
+
+  return model;
+}
+
+void report_bandwidth(const std::string& name, std::size_t bytes, double seconds) {
+  std::cout << "  " << name << ": " << static_cast<double>(bytes) / seconds / (1024.0 * 1024.0 * 1024.0) << " GiB/s\n";
+}
+}  // namespace
+
+int main() {
+  const std::size_t num_faces = 10000000;
+  const Model model           = generate_model(num_faces);
+
+  // Structure of arrays that is already gathered: 9 coordinates in, 3 out per triangle
+  std::vector<std::vector<float>> arrays(12, std::vector<float>(num_faces));
+  for (std::size_t i = 0; i < num_faces; ++i) {
+    for (std::size_t corner = 0; corner < 3; ++corner) {
+      const glm::vec4& position = model.positions[model.triangular_faces[i][corner].x];
+      for (std::size_t coordinate = 0; coordinate < 3; ++coordinate) {
+        arrays[3 * corner + coordinate][i] = position[coordinate];
+      }
+    }
+  }
+  const FaceNormalEngine::TriangleArrays triangles = {{arrays[0].data(), arrays[1].data(), arrays[2].data()},
+                                                      {arrays[3].data(), arrays[4].data(), arrays[5].data()},
+                                                      {arrays[6].data(), arrays[7].data(), arrays[8].data()}};
+  const std::array<float*, 3> normals              = {arrays[9].data(), arrays[10].data(), arrays[11].data()};
+
+  const std::size_t kernel_bytes = num_faces * 12 * sizeof(float);
+  // Faces, the 3 positions (mostly from cache in this mesh, so they are counted once) and the normals
+  const std::size_t model_bytes =
+      num_faces * (sizeof(model.triangular_faces[0]) + sizeof(model.positions[0]) + sizeof(glm::vec3));
+
+  // The same number of bytes copied with memcpy, the upper limit for any kernel that reads and writes them
+  std::vector<char> source(kernel_bytes / 2), destination(kernel_bytes / 2);
+  const double copy_seconds = measure_seconds([&] { std::memcpy(destination.data(), source.data(), source.size()); });
+  std::cout << "memcpy of " << kernel_bytes / 2 / (1024 * 1024) << " MiB:\n";
+  report_bandwidth("read + write", kernel_bytes, copy_seconds);
+
+  std::vector<std::size_t> thread_counts = {1};
+  if (resolve_thread_count(0) > 1) {
+    thread_counts.push_back(resolve_thread_count(0));
+  }
+
+  for (const auto level :
+       {FaceNormalEngine::Level::scalar, FaceNormalEngine::Level::sse2, FaceNormalEngine::Level::avx2}) {
+    const FaceNormalEngine engine{level};
+    if (engine.get_level() != level) {
+      std::cout << simd_level_name(level) << ": not supported by this CPU\n";
+      continue;
+    }
+
+    const double kernel_seconds = measure_seconds([&] { engine.compute(triangles, num_faces, normals); });
+    report(std::string{simd_level_name(level)} + " kernel on gathered arrays", num_faces, "triangles", kernel_seconds);
+    report_bandwidth("kernel", kernel_bytes, kernel_seconds);
+
+    for (const std::size_t num_threads : thread_counts) {
+      const double seconds = measure_seconds([&] { engine.compute(model, num_threads); });
+      report(std::string{simd_level_name(level)} + " model, " + std::to_string(num_threads) + " threads",
+             num_faces,
+             "triangles",
+             seconds);
+      report_bandwidth("gather + kernel", model_bytes, seconds);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include <random>
+#include <string>
+#include <vector>
+
+// GLM needs an extra define to enable transformations
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/transform.hpp>
+
+#include "BenchmarkHelper.hpp"
+#include "Computations.hpp"
+#include "Parallel.hpp"
+#include "PositionArrays.hpp"
+
+namespace {
+// Strip of random triangles, every vertex is shared by 3 of them like in a typical mesh
+Model generate_model(const std::size_t num_faces) {
+  std::mt19937 generator{42};
+  std::uniform_real_distribution<float> coordinate{-100.0f, 100.0f};
+
+  Model model{0};
+  for (std::size_t i = 0; i < num_faces + 2; ++i) {
+    model.positions.push_back({coordinate(generator), coordinate(generator), coordinate(generator), 1});
+  }
+  for (int i = 0; static_cast<std::size_t>(i) < num_faces; ++i) {
+    model.triangular_faces.push_back({glm::ivec3{i, -1, -1}, glm::ivec3{i + 1, -1, -1}, glm::ivec3{i + 2, -1, -1}});
+  }
+
+  return model;
+}
+}  // namespace
+
+// The computations on Model::positions (vec4s) and on PositionArrays (separate x, y and z arrays)
+int main() {
+  const std::size_t num_faces = 5000000;
+  Model model                 = generate_model(num_faces);
+  PositionArrays positions{model.positions};
+
+  float area = 0, array_area = 0;
+  report("surface_area, vec4 positions", num_faces, "triangles", measure_seconds([&] { area = surface_area(model); }));
+  report("surface_area, position arrays",
+         num_faces,
+         "triangles",
+         measure_seconds([&] { array_area = surface_area(model, positions); }));
+
+  // Summed in double in fixed blocks, the same for any number of threads
+  std::vector<std::size_t> thread_counts = {1};
+  if (resolve_thread_count(0) > 1) {
+    thread_counts.push_back(resolve_thread_count(0));
+  }
+  double parallel_area = 0;
+  for (const std::size_t num_threads : thread_counts) {
+    report("parallel_surface_area, " + std::to_string(num_threads) + " threads",
+           num_faces,
+           "triangles",
+           measure_seconds([&] { parallel_area = parallel_surface_area(model, num_threads); }));
+  }
+
+  const glm::vec3 origin{0.5f, 0.25f, 0.125f}, direction{1, 0.3f, -0.2f};
+  int hits = 0, array_hits = 0;
+  report("num_of_intersections, vec4 positions",
+         num_faces,
+         "triangles",
+         measure_seconds([&] { hits = num_of_intersections(origin, direction, model); }));
+  report("num_of_intersections, position arrays",
+         num_faces,
+         "triangles",
+         measure_seconds([&] { array_hits = num_of_intersections(origin, direction, model, positions); }));
+
+  const glm::mat4 rotation = glm::rotate(0.001f, glm::vec3{0, 1, 0});
+  report("transform, vec4 positions",
+         model.positions.size(),
+         "positions",
+         measure_seconds([&] { transform(model, rotation); }));
+  report("transform, position arrays",
+         positions.size(),
+         "positions",
+         measure_seconds([&] { transform(positions, rotation); }));
+
+  // Both layouts give the same results
+  std::cout << "area: " << area << " and " << array_area << ", hits: " << hits << " and " << array_hits << "\n";
+  // The error of the float sum
+  std::cout.precision(17);
+  std::cout << "area summed in double: " << parallel_area << "\n";
+
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchmarkHelper.hpp"
+#include "Computations.hpp"
+#include "Intersections.hpp"
+
+int main() {
+  const std::size_t num_triangles = 10000000;
+
+  // Small random triangles in a cube, so a ray hits a few of them
+  std::mt19937 generator{3};
+  std::uniform_real_distribution<float> coordinate{-1.0f, 1.0f};
+  std::uniform_real_distribution<float> edge{-0.01f, 0.01f};
+
+  std::vector<std::array<glm::vec3, 3>> corners(num_triangles);
+  std::vector<std::vector<float>> arrays(9, std::vector<float>(num_triangles + IntersectionEngine::padding));
+  for (std::size_t i = 0; i < num_triangles; ++i) {
+    const glm::vec3 v0{coordinate(generator), coordinate(generator), coordinate(generator)};
+    const glm::vec3 e1{edge(generator), edge(generator), edge(generator)};
+    const glm::vec3 e2{edge(generator), edge(generator), edge(generator)};
+    corners[i] = {v0, v0 + e1, v0 + e2};
+
+    for (int axis = 0; axis < 3; ++axis) {
+      arrays[axis][i]     = v0[axis];
+      arrays[3 + axis][i] = corners[i][1][axis] - v0[axis];
+      arrays[6 + axis][i] = corners[i][2][axis] - v0[axis];
+    }
+  }
+  const IntersectionEngine::TriangleArrays triangles = {{arrays[0].data(), arrays[1].data(), arrays[2].data()},
+                                                        {arrays[3].data(), arrays[4].data(), arrays[5].data()},
+                                                        {arrays[6].data(), arrays[7].data(), arrays[8].data()}};
+
+  const glm::vec3 origin{0.1f, -0.2f, 0.05f};
+  const glm::vec3 direction{1};
+
+  int expected         = 0;
+  const double seconds = measure_seconds([&] {
+    expected = 0;
+    glm::vec3 point;
+    for (const auto& triangle : corners) {
+      expected += RayIntersectsTriangle(origin, direction, triangle, point);
+    }
+  });
+  report("RayIntersectsTriangle", num_triangles, "triangles", seconds);
+
+  for (auto level :
+       {IntersectionEngine::Level::scalar, IntersectionEngine::Level::sse2, IntersectionEngine::Level::avx2}) {
+    const IntersectionEngine engine{level};
+    if (engine.get_level() != level) {
+      std::cout << simd_level_name(level) << " is not supported\n";
+      continue;
+    }
+
+    int hits                    = 0;
+    const double engine_seconds = measure_seconds([&] { hits = engine.count(origin, direction, triangles, num_triangles); });
+    report(std::string{"IntersectionEngine, "} + simd_level_name(level), num_triangles, "triangles", engine_seconds);
+
+    if (hits != expected) {
+      std::cout << "  different results: " << hits << " hits instead of " << expected << "\n";
+    }
+  }
+
+  std::cout << expected << " hits\n";
+
+  return 0;
+}
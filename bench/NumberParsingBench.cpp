@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <exception>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BenchmarkHelper.hpp"
+#include "StringMethods.hpp"
+
+namespace {
+// The previous implementation of read_numbers: std::stod on a copy of the rest of the line for every number
+template <class Container>
+std::optional<std::size_t> legacy_read_numbers(const std::string& text,
+                                               std::size_t text_position,
+                                               Container& container,
+                                               const std::size_t min,
+                                               const std::size_t max) {
+  std::size_t numbers_read         = 0;
+  std::size_t part_to_process_next = text_position;
+
+  while (numbers_read < max && part_to_process_next < text.size()) {
+    std::size_t chars_processed = 0;
+    try {
+      container[numbers_read] = std::stod(std::string{text, part_to_process_next}, &chars_processed);
+    } catch (const std::exception&) {
+      return std::nullopt;
+    }
+    part_to_process_next += chars_processed;
+    ++numbers_read;
+  }
+
+  if (numbers_read < min || numbers_read > max || part_to_process_next != text.size()) {
+    return std::nullopt;
+  }
+
+  return numbers_read;
+}
+
+std::vector<std::string> generate_position_lines(const std::size_t count) {
+  std::mt19937 generator{42};
+  std::uniform_real_distribution<float> distribution{-1000.0f, 1000.0f};
+
+  std::vector<std::string> lines;
+  lines.reserve(count);
+
+  char line[128];
+  for (std::size_t i = 0; i < count; ++i) {
+    std::snprintf(line,
+                  sizeof(line),
+                  "v %f %f %f",
+                  distribution(generator),
+                  distribution(generator),
+                  distribution(generator));
+    lines.emplace_back(line);
+  }
+
+  return lines;
+}
+
+template <class ReadNumbers>
+std::size_t parse_all(const std::vector<std::string>& lines, ReadNumbers&& read) {
+  std::size_t coordinates = 0;
+  glm::vec4 position;
+
+  for (const auto& line : lines) {
+    if (auto result = read(line, position); result) {
+      coordinates += *result;
+    }
+  }
+
+  return coordinates;
+}
+}  // namespace
+
+int main() {
+  const std::size_t line_count = 1000000;
+  const auto lines             = generate_position_lines(line_count);
+
+  std::size_t legacy_coordinates = 0;
+  std::size_t coordinates        = 0;
+
+  const double legacy_seconds = measure_seconds([&] {
+    legacy_coordinates = parse_all(lines, [](const std::string& line, glm::vec4& position) {
+      return legacy_read_numbers(line, 1, position, 3, 4);
+    });
+  });
+
+  const double seconds = measure_seconds([&] {
+    coordinates = parse_all(
+        lines, [](const std::string& line, glm::vec4& position) { return read_numbers(line, 1, position, 3, 4); });
+  });
+
+  // Both versions have to agree on every value, otherwise the comparison is meaningless
+  std::size_t mismatches = 0;
+  for (const auto& line : lines) {
+    glm::vec4 legacy_position, position;
+    legacy_read_numbers(line, 1, legacy_position, 3, 4);
+    read_numbers(line, 1, position, 3, 4);
+    mismatches += legacy_position.x != position.x || legacy_position.y != position.y || legacy_position.z != position.z;
+  }
+
+  report("std::stod (before)", legacy_coordinates, "coordinates", legacy_seconds);
+  report("std::from_chars (after)", coordinates, "coordinates", seconds);
+  std::cout << "Speedup: " << legacy_seconds / seconds << "x, mismatching lines: " << mismatches << "\n";
+
+  return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "BenchmarkHelper.hpp"
+#include "MappedFile.hpp"
+#include "ObjPrinter.hpp"
+#include "Parallel.hpp"
+
+namespace {
+const std::string output_path = "obj_printer_bench.obj";
+
+// Grid of grid_size x grid_size vertices with texture coordinates and normals, 2 triangles per cell
+Model generate_grid(const std::size_t grid_size) {
+  Model model{0};
+
+  for (std::size_t y = 0; y < grid_size; ++y) {
+    for (std::size_t x = 0; x < grid_size; ++x) {
+      const float u = static_cast<float>(x) / grid_size;
+      const float v = static_cast<float>(y) / grid_size;
+      model.positions.push_back({x * 0.37f, y * 0.61f, u * v, 1});
+      model.texture_coords.push_back({u, v, 0});
+      model.normals.push_back({u, v, 1 - u});
+    }
+  }
+
+  for (std::size_t y = 0; y + 1 < grid_size; ++y) {
+    for (std::size_t x = 0; x + 1 < grid_size; ++x) {
+      const int a = y * grid_size + x;
+      const int b = a + grid_size;
+      model.triangular_faces.push_back({glm::ivec3{a}, glm::ivec3{a + 1}, glm::ivec3{b + 1}});
+      model.triangular_faces.push_back({glm::ivec3{a}, glm::ivec3{b + 1}, glm::ivec3{b}});
+    }
+  }
+
+  return model;
+}
+}  // namespace
+
+int main() {
+  const Model model = generate_grid(2150);
+  const std::size_t lines =
+      model.positions.size() + model.texture_coords.size() + model.normals.size() + model.triangular_faces.size();
+
+  std::vector<std::size_t> thread_counts = {1};
+  if (resolve_thread_count(0) > 1) {
+    thread_counts.push_back(resolve_thread_count(0));
+  }
+
+  ObjPrinter printer;
+  for (const std::size_t num_threads : thread_counts) {
+    printer.set_num_threads(num_threads);
+
+    const double seconds = measure_seconds([&] { printer.print(model, output_path); }, 3);
+    const std::size_t mebibytes = MappedFile::open(output_path)->view().size() / (1024 * 1024);
+
+    report("ObjPrinter " + std::to_string(num_threads) + " threads", lines, "lines", seconds);
+    report("ObjPrinter " + std::to_string(num_threads) + " threads", mebibytes, "MiB", seconds);
+  }
+
+  std::remove(output_path.c_str());
+
+  return 0;
+}
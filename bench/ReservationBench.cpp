@@ -0,0 +1,118 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "BenchmarkHelper.hpp"
+#include "ObjParser.hpp"
+
+namespace {
+// Grid of quads, roughly what a scanned surface looks like
+std::string generate_obj(const std::size_t grid_size) {
+  std::mt19937 generator{42};
+  std::uniform_real_distribution<float> noise{0.0f, 0.01f};
+
+  std::string obj;
+  char line[128];
+
+  for (std::size_t y = 0; y < grid_size; ++y) {
+    for (std::size_t x = 0; x < grid_size; ++x) {
+      std::snprintf(line, sizeof(line), "v %f %f %f\n", x + noise(generator), y + noise(generator), noise(generator));
+      obj += line;
+      std::snprintf(line, sizeof(line), "vn 0.0 0.0 %f\n", 1.0f - noise(generator));
+      obj += line;
+    }
+  }
+
+  for (std::size_t y = 0; y + 1 < grid_size; ++y) {
+    for (std::size_t x = 0; x + 1 < grid_size; ++x) {
+      const std::size_t a = y * grid_size + x + 1;
+      std::snprintf(line,
+                    sizeof(line),
+                    "f %zu//%zu %zu//%zu %zu//%zu %zu//%zu\n",
+                    a,
+                    a,
+                    a + 1,
+                    a + 1,
+                    a + grid_size + 1,
+                    a + grid_size + 1,
+                    a + grid_size,
+                    a + grid_size);
+      obj += line;
+    }
+  }
+
+  return obj;
+}
+
+// Value of a "VmRSS:"-like field of /proc/self/status in KiB
+std::size_t read_status_kib(const std::string& field) {
+  std::ifstream status{"/proc/self/status"};
+  for (std::string line; std::getline(status, line);) {
+    if (line.compare(0, field.size(), field) == 0) {
+      return std::stoul(line.substr(field.size()));
+    }
+  }
+
+  return 0;
+}
+
+class ObjParserBench : public ObjParser {
+ public:
+  // The parse before the counting pass: vectors start from the default reservation and grow as needed
+  std::size_t parse_growing(std::string_view data) {
+    Model model;
+    std::size_t lines_processed = 0;
+    process_lines(data, model, lines_processed);
+    return model.triangular_faces.size();
+  }
+
+  std::size_t parse_reserved(std::string_view data) { return parse_buffer(data)->triangular_faces.size(); }
+};
+
+// Runs parse in a child process, so every variant starts from the same memory state, and reports the memory the
+// parse added on top of the input text at its peak
+template <class Parse>
+void measure_in_child(const std::string& name, const std::string& obj, Parse&& parse) {
+  std::cout.flush();
+
+  const pid_t pid = fork();
+  if (pid == 0) {
+    const std::size_t rss_before = read_status_kib("VmRSS:");
+
+    std::size_t triangles = 0;
+    const double seconds  = measure_seconds([&] { triangles = parse(obj); }, 1);
+
+    const std::size_t peak = read_status_kib("VmHWM:");
+    report(name, triangles, "triangles", seconds);
+    std::cout << "  peak memory used by parsing: " << (peak - rss_before) / 1024 << " MiB\n";
+    std::cout.flush();
+    _exit(0);
+  }
+
+  waitpid(pid, nullptr, 0);
+}
+}  // namespace
+
+int main() {
+  const std::string obj = generate_obj(1500);
+  std::cout << "Input: " << obj.size() / (1024 * 1024) << " MiB of OBJ text\n";
+
+  ObjParserBench parser;
+  parser.set_num_threads(1);
+
+  const auto size = ObjParser::count_elements(obj);
+  const std::size_t model_bytes =
+      size.positions * sizeof(glm::vec4) + size.normals * sizeof(glm::vec3) +
+      size.triangular_faces * sizeof(std::array<glm::ivec3, 3>);
+  std::cout << "Size of the parsed model: " << model_bytes / (1024 * 1024) << " MiB\n";
+
+  const double count_seconds = measure_seconds([&] { ObjParser::count_elements(obj); });
+  report("Counting pass", obj.size() / (1024 * 1024), "MiB", count_seconds);
+
+  measure_in_child("Growing vectors (before)", obj, [&](const std::string& data) { return parser.parse_growing(data); });
+  measure_in_child("Exact reservation (after)", obj, [&](const std::string& data) { return parser.parse_reserved(data); });
+}
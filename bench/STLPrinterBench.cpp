@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "AsciiSTLPrinter.hpp"
+#include "BenchmarkHelper.hpp"
+#include "ObjParser.hpp"
+#include "Parallel.hpp"
+#include "STLPrinter.hpp"
+
+namespace {
+const std::string output_path = "stl_printer_bench.stl";
+
+// The printer before the buffered writer: one std::ofstream::write call per float
+bool print_legacy(const Model& model, const std::string& path) {
+  std::ofstream out{path, std::ios::binary};
+
+  const auto write_vec = [&out](const auto& vec) {
+    out.write(reinterpret_cast<const char*>(&vec.x), sizeof(float));
+    out.write(reinterpret_cast<const char*>(&vec.y), sizeof(float));
+    out.write(reinterpret_cast<const char*>(&vec.z), sizeof(float));
+  };
+
+  const std::string header(80, ' ');
+  const uint32_t num_of_faces = model.triangular_faces.size();
+  out.write(header.data(), header.size());
+  out.write(reinterpret_cast<const char*>(&num_of_faces), sizeof(uint32_t));
+
+  for (const auto& face : model.triangular_faces) {
+    const uint16_t attrib_byte_cnt = 0;
+    const int normal_index         = face[0].z;
+    if (normal_index >= 0 && static_cast<std::size_t>(normal_index) < model.normals.size()) {
+      write_vec(model.normals[normal_index]);
+    } else {
+      write_vec(glm::vec3{0});
+    }
+    write_vec(model.positions[face[0].x]);
+    write_vec(model.positions[face[1].x]);
+    write_vec(model.positions[face[2].x]);
+    out.write(reinterpret_cast<const char*>(&attrib_byte_cnt), sizeof(uint16_t));
+  }
+
+  return static_cast<bool>(out);
+}
+
+// Grid of grid_size x grid_size vertices split into 2 triangles per cell, with one normal
+Model generate_grid(const std::size_t grid_size) {
+  Model model{0};
+  model.positions.reserve(grid_size * grid_size);
+  model.triangular_faces.reserve(2 * (grid_size - 1) * (grid_size - 1));
+  model.normals.push_back({0, 0, 1});
+
+  for (std::size_t y = 0; y < grid_size; ++y) {
+    for (std::size_t x = 0; x < grid_size; ++x) {
+      model.positions.push_back({x, y, 0, 1});
+    }
+  }
+
+  for (std::size_t y = 0; y + 1 < grid_size; ++y) {
+    for (std::size_t x = 0; x + 1 < grid_size; ++x) {
+      const int a = y * grid_size + x;
+      const int b = a + grid_size;
+      model.triangular_faces.push_back({glm::ivec3{a, -1, 0}, glm::ivec3{a + 1, -1, 0}, glm::ivec3{b + 1, -1, 0}});
+      model.triangular_faces.push_back({glm::ivec3{a, -1, 0}, glm::ivec3{b + 1, -1, 0}, glm::ivec3{b, -1, 0}});
+    }
+  }
+
+  return model;
+}
+
+void bench_model(const std::string& name, const Model& model) {
+  STLPrinter printer;
+  const std::size_t triangles = model.triangular_faces.size();
+
+  report(name + " legacy ofstream", triangles, "triangles", measure_seconds([&] { print_legacy(model, output_path); }));
+
+  printer.set_num_threads(1);
+  report(name + " STLPrinter", triangles, "triangles", measure_seconds([&] { printer.print(model, output_path); }));
+
+  // Large models are written into a memory mapping of the output by all hardware threads
+  printer.set_num_threads(0);
+  report(name + " STLPrinter " + std::to_string(resolve_thread_count(0)) + " threads",
+         triangles,
+         "triangles",
+         measure_seconds([&] { printer.print(model, output_path); }));
+
+  AsciiSTLPrinter ascii_printer;
+  report(name + " AsciiSTLPrinter " + std::to_string(resolve_thread_count(0)) + " threads",
+         triangles,
+         "triangles",
+         measure_seconds([&] { ascii_printer.print(model, output_path); }, 3));
+}
+}  // namespace
+
+// Usage: STLPrinterBench [path/to/wolf.obj], the default works from the build folder
+int main(int argc, const char* argv[]) {
+  const std::string wolf_path = argc > 1 ? argv[1] : "../assets/wolf.obj";
+
+  ObjParser parser;
+  if (const auto wolf = parser.parse(wolf_path); wolf) {
+    bench_model("wolf.obj", *wolf);
+  } else {
+    std::cerr << "Skipping wolf.obj, pass its path as the first argument\n";
+  }
+
+  // 2 * 2237^2 is just over 10 million triangles
+  bench_model("10M triangle grid", generate_grid(2238));
+
+  std::remove(output_path.c_str());
+
+  return 0;
+}
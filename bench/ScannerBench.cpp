@@ -0,0 +1,85 @@
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "BenchmarkHelper.hpp"
+#include "ObjParser.hpp"
+#include "StructuralScanner.hpp"
+
+namespace {
+// Vertices and quads with the number formatting of typical exporters
+std::string generate_obj(const std::size_t num_vertices) {
+  std::mt19937 generator{42};
+  std::uniform_real_distribution<float> distribution{-100.0f, 100.0f};
+
+  std::string obj;
+  char line[128];
+
+  for (std::size_t i = 0; i < num_vertices; ++i) {
+    std::snprintf(
+        line, sizeof(line), "v %f %f %f\n", distribution(generator), distribution(generator), distribution(generator));
+    obj += line;
+  }
+
+  for (std::size_t i = 1; i + 3 <= num_vertices; i += 2) {
+    std::snprintf(line, sizeof(line), "f %zu//1 %zu//1 %zu//1 %zu//1\n", i, i + 1, i + 2, i + 3);
+    obj += line;
+  }
+
+  return obj;
+}
+
+class ObjParserBench : public ObjParser {
+ public:
+  std::optional<Model> parse(std::string_view data) { return parse_buffer(data); }
+};
+}  // namespace
+
+int main() {
+  const std::string obj = generate_obj(2000000);
+  const std::size_t megabytes = obj.size() / (1024 * 1024);
+
+  std::cout << "Input: " << megabytes << " MiB of OBJ text\n";
+
+  for (const auto level :
+       {StructuralScanner::Level::scalar, StructuralScanner::Level::sse2, StructuralScanner::Level::avx2}) {
+    const StructuralScanner scanner{level};
+    if (scanner.get_level() != level) {
+      std::cout << simd_level_name(level) << ": not supported by this CPU\n";
+      continue;
+    }
+
+    std::size_t lines = 0, tokens = 0;
+
+    const double line_seconds = measure_seconds([&] {
+      lines = 0;
+      LineScanner line_scanner{obj, scanner};
+      for (std::string_view line; line_scanner.next(line);) {
+        ++lines;
+      }
+    });
+
+    // Line boundaries plus the space separated tokens inside each line, which is what the parser looks for
+    const double token_seconds = measure_seconds([&] {
+      tokens = 0;
+      LineScanner line_scanner{obj, scanner};
+      for (std::string_view line; line_scanner.next(line);) {
+        const char* const end = line.data() + line.size();
+        for (const char* it = scanner.find_not(line.data(), end, ' '); it != end;
+             it             = scanner.find_not(scanner.find(it, end, ' '), end, ' ')) {
+          ++tokens;
+        }
+      }
+    });
+
+    std::cout << simd_level_name(level) << ":\n";
+    report("  lines", megabytes, "MiB", line_seconds);
+    report("  lines, then tokens in each line", megabytes, "MiB", token_seconds);
+    std::cout << "  (" << lines << " lines, " << tokens << " tokens)\n";
+  }
+
+  ObjParserBench parser;
+  parser.set_num_threads(1);
+  const double parse_seconds = measure_seconds([&] { parser.parse(obj); }, 3);
+  report("Full single threaded parse", megabytes, "MiB", parse_seconds);
+}
@@ -0,0 +1,57 @@
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchmarkHelper.hpp"
+#include "Parallel.hpp"
+#include "Weld.hpp"
+
+namespace {
+// Triangle soup of a grid of side x side vertices, like a mesh read from STL: every corner of every triangle is a
+// separate position, moved by a little noise
+Model generate_soup(const int side) {
+  std::mt19937 generator{42};
+  std::uniform_real_distribution<float> noise{-1e-5f, 1e-5f};
+
+  Model model{0};
+  model.positions.reserve(6 * static_cast<std::size_t>(side - 1) * (side - 1));
+  model.triangular_faces.reserve(2 * static_cast<std::size_t>(side - 1) * (side - 1));
+
+  const auto corner = [&](int x, int y) {
+    model.positions.push_back({x * 0.01f + noise(generator), y * 0.01f + noise(generator), noise(generator), 1});
+    return glm::ivec3{static_cast<int>(model.positions.size()) - 1, -1, -1};
+  };
+
+  for (int y = 0; y + 1 < side; ++y) {
+    for (int x = 0; x + 1 < side; ++x) {
+      model.triangular_faces.push_back({corner(x, y), corner(x + 1, y), corner(x + 1, y + 1)});
+      model.triangular_faces.push_back({corner(x, y), corner(x + 1, y + 1), corner(x, y + 1)});
+    }
+  }
+
+  return model;
+}
+}  // namespace
+
+// The side of the grid can be passed as the first argument, the default gives about 50 million positions
+int main(int argc, const char* argv[]) {
+  const int side     = argc > 1 ? std::atoi(argv[1]) : 2900;
+  const Model source = generate_soup(side);
+
+  std::vector<std::size_t> thread_counts = {1};
+  if (resolve_thread_count(0) > 1) {
+    thread_counts.push_back(resolve_thread_count(0));
+  }
+
+  for (const std::size_t num_threads : thread_counts) {
+    Model model          = source;
+    std::size_t removed  = 0;
+    const double seconds = measure_seconds([&] { removed = weld_positions(model, 1e-4f, num_threads); }, 1);
+
+    report("weld, " + std::to_string(num_threads) + " threads", source.positions.size(), "positions", seconds);
+    std::cout << "  " << removed << " removed, " << model.positions.size() << " kept\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,501 @@
+#include "BVH.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../Parallel/Parallel.hpp"
+
+namespace {
+const std::size_t num_bins = 16;
+// Nodes with at most this many triangles are always leaves. The intersection engine tests 8 triangles at once, so
+// splitting them would only add nodes to visit
+const std::size_t min_leaf_size = 8;
+// Leaves can be this large if splitting them doesn't pay off according to the heuristic
+const std::size_t max_leaf_size = 16;
+// Nodes with more triangles are binned in parallel, the ones below are built as separate tasks
+const std::size_t task_size = 1 << 15;
+// Triangles binned by one parallel task
+const std::size_t triangles_per_chunk = 1 << 14;
+
+struct Bounds {
+  glm::vec3 min{std::numeric_limits<float>::infinity()};
+  glm::vec3 max{-std::numeric_limits<float>::infinity()};
+
+  void grow(const glm::vec3& point) {
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+  }
+
+  void grow(const Bounds& other) {
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+  }
+
+  float area() const {
+    const glm::vec3 extent = max - min;
+    return extent.x < 0 ? 0 : extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+  }
+};
+
+// Bounds of the triangles of a node, and of their centroids, which are binned
+struct NodeBounds {
+  Bounds bounds;
+  Bounds centroids;
+
+  void grow(const NodeBounds& other) {
+    bounds.grow(other.bounds);
+    centroids.grow(other.centroids);
+  }
+};
+
+// Maps centroids to bins along the axis where the centroids are the most spread out, with one multiplication
+struct Binning {
+  explicit Binning(const Bounds& centroids) : min{centroids.min} {
+    const glm::vec3 extent = centroids.max - centroids.min;
+    axis                   = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+    scale                  = extent[axis] > 0 ? num_bins / extent[axis] : 0;
+  }
+
+  std::size_t bin(const glm::vec3& centroid) const {
+    return std::min(static_cast<std::size_t>((centroid[axis] - min[axis]) * scale), num_bins - 1);
+  }
+
+  glm::vec3 min;
+  int axis;
+  // 0 if all centroids are in one point
+  float scale;
+};
+
+struct Bin {
+  NodeBounds bounds;
+  std::size_t count = 0;
+};
+
+using Bins = std::array<Bin, num_bins>;
+
+// A triangle while building, its data is moved with it when the triangles are partitioned, so it's read in order
+struct Reference {
+  Bounds bounds;
+  glm::vec3 centroid;
+  std::uint32_t triangle;
+};
+
+// A part of the tree that is built as a separate task, node is its root
+struct Subtree {
+  std::size_t node;
+  std::size_t first;
+  std::size_t count;
+  NodeBounds bounds;
+  // Of node, the root is at depth 0
+  std::size_t depth;
+};
+
+class Builder {
+ public:
+  Builder(const Model& model, std::size_t num_threads) : num_threads{num_threads} {
+    const std::size_t num_faces = model.triangular_faces.size();
+    references.resize(num_faces);
+
+    parallel_for(num_chunks(num_faces), num_threads, [&](std::size_t chunk) {
+      const std::size_t last = std::min((chunk + 1) * triangles_per_chunk, num_faces);
+
+      for (std::size_t i = chunk * triangles_per_chunk; i < last; ++i) {
+        Bounds bounds;
+        for (const auto& corner : model.triangular_faces[i]) {
+          bounds.grow(glm::vec3{model.positions[corner.x]});
+        }
+
+        // A little larger than the triangle, so rays that the intersection test counts as hits because of rounding
+        // don't miss the box
+        const glm::vec3 padding = (bounds.max - bounds.min) * 1e-5f +
+                                  glm::max(glm::abs(bounds.min), glm::abs(bounds.max)) * 1e-6f + glm::vec3{1e-30f};
+        bounds.min -= padding;
+        bounds.max += padding;
+
+        references[i] = {bounds, (bounds.min + bounds.max) * 0.5f, static_cast<std::uint32_t>(i)};
+      }
+    });
+  }
+
+  // Builds the tree into nodes, afterwards the leaves point into get_references()
+  void build(std::vector<BVH::Node>& nodes) {
+    if (references.empty()) {
+      return;
+    }
+
+    const std::size_t chunks = num_chunks(references.size());
+    std::vector<NodeBounds> chunk_bounds(chunks);
+    parallel_for(chunks, num_threads, [&](std::size_t chunk) {
+      const std::size_t first = chunk * triangles_per_chunk;
+      chunk_bounds[chunk]     = compute_bounds(first, std::min(triangles_per_chunk, references.size() - first));
+    });
+
+    NodeBounds bounds;
+    for (const auto& chunk : chunk_bounds) {
+      bounds.grow(chunk);
+    }
+
+    std::vector<Subtree> subtrees;
+    nodes.emplace_back();
+    build_top(nodes, {0, 0, references.size(), bounds, 0}, subtrees);
+
+    std::vector<std::vector<BVH::Node>> subtree_nodes(subtrees.size());
+    parallel_for(subtrees.size(), num_threads, [&](std::size_t i) {
+      subtree_nodes[i].emplace_back();
+      build_node(subtree_nodes[i], {0, subtrees[i].first, subtrees[i].count, subtrees[i].bounds, subtrees[i].depth});
+    });
+
+    // Subtrees are appended in a fixed order, their root replaces the placeholder node of the subtree
+    for (std::size_t i = 0; i < subtrees.size(); ++i) {
+      const std::size_t offset = nodes.size();
+      const auto to_global     = [&](BVH::Node node) {
+        if (!node.is_leaf()) {
+          node.index = static_cast<std::uint32_t>(offset + node.index - 1);
+        }
+        return node;
+      };
+
+      nodes[subtrees[i].node] = to_global(subtree_nodes[i][0]);
+      for (std::size_t j = 1; j < subtree_nodes[i].size(); ++j) {
+        nodes.push_back(to_global(subtree_nodes[i][j]));
+      }
+    }
+  }
+
+  const std::vector<Reference>& get_references() const { return references; }
+
+ private:
+  static std::size_t num_chunks(std::size_t count) { return (count + triangles_per_chunk - 1) / triangles_per_chunk; }
+
+  // Splits the large nodes with parallel binning, and leaves the smaller ones for tasks
+  void build_top(std::vector<BVH::Node>& nodes, const Subtree& tree, std::vector<Subtree>& subtrees) {
+    if (tree.count <= task_size || tree.depth == BVH::max_depth) {
+      subtrees.push_back(tree);
+      return;
+    }
+
+    // Bins of every chunk, merged in the order of the chunks
+    const Binning binning{tree.bounds.centroids};
+    const std::size_t chunks = num_chunks(tree.count);
+    std::vector<Bins> chunk_bins(chunks);
+    parallel_for(chunks, num_threads, [&](std::size_t chunk) {
+      const std::size_t first = tree.first + chunk * triangles_per_chunk;
+      fill_bins(first, std::min(triangles_per_chunk, tree.first + tree.count - first), binning, chunk_bins[chunk]);
+    });
+
+    Bins bins;
+    for (const auto& chunk : chunk_bins) {
+      for (std::size_t bin = 0; bin < num_bins; ++bin) {
+        bins[bin].bounds.grow(chunk[bin].bounds);
+        bins[bin].count += chunk[bin].count;
+      }
+    }
+
+    NodeBounds left_bounds, right_bounds;
+    const std::size_t left_count = split(tree, binning, bins, left_bounds, right_bounds);
+    const std::size_t left       = add_children(nodes, tree);
+
+    build_top(nodes, {left, tree.first, left_count, left_bounds, tree.depth + 1}, subtrees);
+    build_top(
+        nodes, {left + 1, tree.first + left_count, tree.count - left_count, right_bounds, tree.depth + 1}, subtrees);
+  }
+
+  void build_node(std::vector<BVH::Node>& nodes, const Subtree& tree) {
+    NodeBounds left_bounds, right_bounds;
+    std::size_t left_count = 0;
+
+    // The depth is bounded, so the traversals can keep their stacks in fixed size arrays
+    if (tree.count > min_leaf_size && tree.depth < BVH::max_depth) {
+      const Binning binning{tree.bounds.centroids};
+      Bins bins;
+      fill_bins(tree.first, tree.count, binning, bins);
+      left_count = split(tree, binning, bins, left_bounds, right_bounds);
+    }
+
+    if (left_count == 0) {
+      const Bounds& bounds = tree.bounds.bounds;
+      nodes[tree.node]     = {
+          bounds.min, static_cast<std::uint32_t>(tree.first), bounds.max, static_cast<std::uint32_t>(tree.count)};
+      return;
+    }
+
+    const std::size_t left = add_children(nodes, tree);
+    build_node(nodes, {left, tree.first, left_count, left_bounds, tree.depth + 1});
+    build_node(nodes, {left + 1, tree.first + left_count, tree.count - left_count, right_bounds, tree.depth + 1});
+  }
+
+  // Makes tree.node an inner node, and returns the index of its left child
+  static std::size_t add_children(std::vector<BVH::Node>& nodes, const Subtree& tree) {
+    const std::size_t left = nodes.size();
+    nodes[tree.node]       = {tree.bounds.bounds.min, static_cast<std::uint32_t>(left), tree.bounds.bounds.max, 0};
+    nodes.emplace_back();
+    nodes.emplace_back();
+    return left;
+  }
+
+  NodeBounds compute_bounds(std::size_t first, std::size_t count) const {
+    NodeBounds bounds;
+    for (std::size_t i = first; i < first + count; ++i) {
+      bounds.bounds.grow(references[i].bounds);
+      bounds.centroids.grow(references[i].centroid);
+    }
+    return bounds;
+  }
+
+  void fill_bins(std::size_t first, std::size_t count, const Binning& binning, Bins& bins) const {
+    for (std::size_t i = first; i < first + count; ++i) {
+      const Reference& reference = references[i];
+      Bin& bin                   = bins[binning.bin(reference.centroid)];
+      bin.bounds.bounds.grow(reference.bounds);
+      bin.bounds.centroids.grow(reference.centroid);
+      ++bin.count;
+    }
+  }
+
+  // Partitions the triangles of tree by the cheapest split between the bins, and returns the number on the left, or 0
+  // if the node is better off as a leaf. The bounds of the two sides are merged from the bins
+  std::size_t split(const Subtree& tree,
+                    const Binning& binning,
+                    const Bins& bins,
+                    NodeBounds& left_bounds,
+                    NodeBounds& right_bounds) {
+    const std::size_t count = tree.count;
+
+    // All centroids in one point: the order can't tell the triangles apart, so large nodes are halved
+    if (binning.scale == 0) {
+      if (count <= max_leaf_size) {
+        return 0;
+      }
+      left_bounds  = compute_bounds(tree.first, count / 2);
+      right_bounds = compute_bounds(tree.first + count / 2, count - count / 2);
+      return count / 2;
+    }
+
+    // Areas and counts of the bins right of each split, then swept from the left
+    std::array<float, num_bins> right_areas;
+    std::array<std::size_t, num_bins> right_counts;
+    Bounds right;
+    std::size_t right_count = 0;
+    for (std::size_t bin = num_bins - 1; bin > 0; --bin) {
+      right.grow(bins[bin].bounds.bounds);
+      right_count += bins[bin].count;
+      right_areas[bin]  = right.area();
+      right_counts[bin] = right_count;
+    }
+
+    std::size_t best_bin = 0;
+    float best_cost      = std::numeric_limits<float>::infinity();
+    Bounds left;
+    std::size_t left_count = 0;
+    for (std::size_t bin = 1; bin < num_bins; ++bin) {
+      left.grow(bins[bin - 1].bounds.bounds);
+      left_count += bins[bin - 1].count;
+
+      const float cost = left_count * left.area() + right_counts[bin] * right_areas[bin];
+      if (left_count > 0 && right_counts[bin] > 0 && cost < best_cost) {
+        best_bin  = bin;
+        best_cost = cost;
+      }
+    }
+
+    // Costs relative to testing one triangle, visiting a node costs about the same
+    const float area = tree.bounds.bounds.area();
+    if (best_bin == 0 || (best_cost + area >= count * area && count <= max_leaf_size)) {
+      return 0;
+    }
+
+    for (std::size_t bin = 0; bin < num_bins; ++bin) {
+      (bin < best_bin ? left_bounds : right_bounds).grow(bins[bin].bounds);
+    }
+
+    const auto begin  = references.begin() + tree.first;
+    const auto middle = std::partition(begin, begin + count, [&](const Reference& reference) {
+      return binning.bin(reference.centroid) < best_bin;
+    });
+    return middle - begin;
+  }
+
+  std::size_t num_threads;
+  std::vector<Reference> references;
+};
+
+// Slab test. Division by 0 gives infinite or NaN distances, the comparisons are written so NaN doesn't cut the range
+// It has no branches, so the packet loop over it is vectorised
+bool hits_box(const BVH::Node& node, const glm::vec3& rayOrigin, const glm::vec3& inverse) {
+  float near = 0, far = max_intersection_distance;
+  for (int axis = 0; axis < 3; ++axis) {
+    const float t0 = (node.min[axis] - rayOrigin[axis]) * inverse[axis];
+    const float t1 = (node.max[axis] - rayOrigin[axis]) * inverse[axis];
+    const float lo = t0 > t1 ? t1 : t0;
+    // Rounded up a little, so the test is conservative
+    const float hi = (t0 > t1 ? t0 : t1) * 1.0000008f;
+    near           = lo > near ? lo : near;
+    far            = hi < far ? hi : far;
+  }
+  return near <= far;
+}
+}  // namespace
+
+BVH::BVH(const Model& model, std::size_t num_threads) {
+  Builder builder{model, num_threads};
+  builder.build(nodes);
+
+  const auto& references = builder.get_references();
+  triangles              = references.size();
+  for (int axis = 0; axis < 3; ++axis) {
+    v0[axis].resize(triangles + IntersectionEngine::padding);
+    e1[axis].resize(triangles + IntersectionEngine::padding);
+    e2[axis].resize(triangles + IntersectionEngine::padding);
+  }
+
+  parallel_for((references.size() + triangles_per_chunk - 1) / triangles_per_chunk, num_threads, [&](std::size_t chunk) {
+    const std::size_t last = std::min((chunk + 1) * triangles_per_chunk, references.size());
+
+    for (std::size_t i = chunk * triangles_per_chunk; i < last; ++i) {
+      const auto& face        = model.triangular_faces[references[i].triangle];
+      const glm::vec3 vertex0 = glm::vec3{model.positions[face[0].x]};
+      const glm::vec3 edge1   = glm::vec3{model.positions[face[1].x]} - vertex0;
+      const glm::vec3 edge2   = glm::vec3{model.positions[face[2].x]} - vertex0;
+
+      for (int axis = 0; axis < 3; ++axis) {
+        v0[axis][i] = vertex0[axis];
+        e1[axis][i] = edge1[axis];
+        e2[axis][i] = edge2[axis];
+      }
+    }
+  });
+}
+
+int BVH::num_of_intersections(const glm::vec3& rayOrigin, const glm::vec3& rayVector) const {
+  if (nodes.empty()) {
+    return 0;
+  }
+
+  return subtree_intersections(0, rayOrigin, rayVector, 1.0f / rayVector);
+}
+
+void BVH::num_of_intersections(const glm::vec3* rayOrigins,
+                               std::size_t count,
+                               const glm::vec3& rayVector,
+                               int* counts) const {
+  if (nodes.empty()) {
+    std::fill(counts, counts + count, 0);
+    return;
+  }
+
+  const glm::vec3 inverse = 1.0f / rayVector;
+  for (std::size_t first = 0; first < count; first += packet_size) {
+    packet_intersections(
+        rayOrigins + first, std::min(packet_size, count - first), rayVector, inverse, counts + first);
+  }
+}
+
+int BVH::subtree_intersections(std::uint32_t root,
+                               const glm::vec3& rayOrigin,
+                               const glm::vec3& rayVector,
+                               const glm::vec3& inverse) const {
+  const IntersectionEngine& engine = IntersectionEngine::best();
+
+  int count = 0;
+  std::array<std::uint32_t, traversal_stack_size> stack;
+  std::size_t depth = 0;
+  stack[depth++]    = root;
+
+  while (depth > 0) {
+    const Node& node = nodes[stack[--depth]];
+
+    if (!hits_box(node, rayOrigin, inverse)) {
+      continue;
+    }
+
+    if (node.is_leaf()) {
+      count += engine.count(rayOrigin, rayVector, triangle_arrays(node.index), node.count);
+    } else {
+      stack[depth++] = node.index + 1;
+      stack[depth++] = node.index;
+    }
+  }
+
+  return count;
+}
+
+// The rays are the lanes of arrays, so the loops over them are vectorised. They use the same box and hit tests as single
+// rays, only the terms that depend on the direction alone are computed once per triangle for the whole packet
+void BVH::packet_intersections(const glm::vec3* rayOrigins,
+                               std::size_t count,
+                               const glm::vec3& rayVector,
+                               const glm::vec3& inverse,
+                               int* counts) const {
+  // Missing rays of the last packet repeat the first one, they are never active
+  std::array<std::array<float, packet_size>, 3> origins;
+  std::array<int, packet_size> hits{};
+  for (std::size_t lane = 0; lane < packet_size; ++lane) {
+    for (int axis = 0; axis < 3; ++axis) {
+      origins[axis][lane] = rayOrigins[lane < count ? lane : 0][axis];
+    }
+  }
+
+  // Nodes with the mask of the rays that reached them
+  std::array<std::pair<std::uint32_t, std::uint32_t>, traversal_stack_size> stack;
+  std::size_t depth = 0;
+  stack[depth++]    = {0, (1u << count) - 1};
+
+  while (depth > 0) {
+    const auto [index, parent_mask] = stack[--depth];
+    const Node& node = nodes[index];
+
+    std::array<int, packet_size> active;
+    for (std::size_t lane = 0; lane < packet_size; ++lane) {
+      const glm::vec3 origin{origins[0][lane], origins[1][lane], origins[2][lane]};
+      active[lane] = hits_box(node, origin, inverse) & (parent_mask >> lane & 1);
+    }
+
+    std::uint32_t mask = 0;
+    for (std::size_t lane = 0; lane < packet_size; ++lane) {
+      mask |= static_cast<std::uint32_t>(active[lane]) << lane;
+    }
+
+    if (mask == 0) {
+      continue;
+    }
+
+    // The packet has diverged down to one ray, which goes on alone
+    if ((mask & (mask - 1)) == 0) {
+      const int lane = __builtin_ctz(mask);
+      hits[lane] += subtree_intersections(index, rayOrigins[lane], rayVector, inverse);
+      continue;
+    }
+
+    if (!node.is_leaf()) {
+      stack[depth++] = {node.index + 1, mask};
+      stack[depth++] = {node.index, mask};
+      continue;
+    }
+
+    for (std::size_t i = node.index; i < node.index + node.count; ++i) {
+      const glm::vec3 corner{v0[0][i], v0[1][i], v0[2][i]};
+      const glm::vec3 edge1{e1[0][i], e1[1][i], e1[2][i]};
+      const glm::vec3 edge2{e2[0][i], e2[1][i], e2[2][i]};
+
+      const DirectionTerms terms = direction_terms(rayVector, edge2, edge1);
+      if (terms.parallel()) {
+        continue;
+      }
+
+      for (std::size_t lane = 0; lane < packet_size; ++lane) {
+        const glm::vec3 origin{origins[0][lane], origins[1][lane], origins[2][lane]};
+        float t;
+        hits[lane] += active[lane] & ray_hits_triangle(origin, rayVector, terms, corner, edge1, edge2, t);
+      }
+    }
+  }
+
+  std::copy(hits.begin(), hits.begin() + count, counts);
+}
+
+IntersectionEngine::TriangleArrays BVH::triangle_arrays(std::uint32_t first) const {
+  return {{v0[0].data() + first, v0[1].data() + first, v0[2].data() + first},
+          {e1[0].data() + first, e1[1].data() + first, e1[2].data() + first},
+          {e2[0].data() + first, e2[1].data() + first, e2[2].data() + first}};
+}
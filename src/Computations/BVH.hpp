@@ -0,0 +1,86 @@
+#ifndef COMPUTATIONS_BVH_HPP
+#define COMPUTATIONS_BVH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../Types/AlignedVector.hpp"
+#include "../Types/Model.hpp"
+#include "Intersections.hpp"
+
+// Bounding volume hierarchy over the triangles of a model, so a ray is only tested against the triangles whose boxes
+// it passes through. Built once and reused for any number of queries, it doesn't refer to the model afterwards
+// The splits are chosen with the surface area heuristic, evaluated on bins of triangle centroids. Large nodes are
+// binned in parallel and the subtrees below them are built as parallel tasks. The tree is the same for any number
+// of threads
+class BVH {
+ public:
+  struct Node {
+    glm::vec3 min;
+    // First triangle of a leaf, or the left child of an inner node (the right one is right after it)
+    std::uint32_t index;
+    glm::vec3 max;
+    // Number of triangles of a leaf, 0 for inner nodes
+    std::uint32_t count;
+
+    bool is_leaf() const { return count > 0; }
+  };
+
+  // Nodes deeper than this are leaves, however many triangles they have. Splits that halve the triangles stay far
+  // above it, only degenerate splits that peel off a few triangles at a time reach it
+  static constexpr std::size_t max_depth = 64;
+
+  BVH() = default;
+  // Uses at most num_threads threads to build (0 means all hardware threads)
+  explicit BVH(const Model& model, std::size_t num_threads = 0);
+
+  // The same count as num_of_intersections(rayOrigin, rayVector, model) for the model it was built from
+  int num_of_intersections(const glm::vec3& rayOrigin, const glm::vec3& rayVector) const;
+
+  // Rays traced together by the packet traversal
+  static constexpr std::size_t packet_size = 8;
+
+  // Writes the number of hits of the ray from each of the count origins in the direction rayVector to counts. The same
+  // counts as num_of_intersections for every origin, but the rays are traced in packets: the nodes and triangles are
+  // loaded once for the whole packet. Works best if consecutive origins are close to each other
+  void num_of_intersections(const glm::vec3* rayOrigins,
+                            std::size_t count,
+                            const glm::vec3& rayVector,
+                            int* counts) const;
+
+  const std::vector<Node>& get_nodes() const { return nodes; }
+  std::size_t num_triangles() const { return triangles; }
+
+ private:
+  // Single ray traversal of the subtree below root
+  int subtree_intersections(std::uint32_t root,
+                            const glm::vec3& rayOrigin,
+                            const glm::vec3& rayVector,
+                            const glm::vec3& inverse) const;
+  // Traversal of a packet of at most packet_size rays
+  void packet_intersections(const glm::vec3* rayOrigins,
+                            std::size_t count,
+                            const glm::vec3& rayVector,
+                            const glm::vec3& inverse,
+                            int* counts) const;
+  // Entries of the traversal stacks. Popping an inner node at depth d leaves at most one pending sibling on each of the
+  // levels 1 to d, then its 2 children are pushed
+  static constexpr std::size_t traversal_stack_size = max_depth + 1;
+
+  // The triangles from first on, for the intersection engine
+  IntersectionEngine::TriangleArrays triangle_arrays(std::uint32_t first) const;
+
+  std::vector<Node> nodes;
+  std::size_t triangles = 0;
+  // The triangles in the order of the leaves: the first corner and the 2 edges from it, x, y and z in separate arrays,
+  // padded for the intersection engine, which tests the triangles of a leaf together
+  std::array<AlignedVector<float>, 3> v0;
+  std::array<AlignedVector<float>, 3> e1;
+  std::array<AlignedVector<float>, 3> e2;
+};
+
+#endif
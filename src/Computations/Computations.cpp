@@ -1,39 +1,203 @@
 #include "Computations.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <variant>
+
 #include <glm/glm.hpp>
 
-// Möller–Trumbore intersection algorithm
-// Source: https://en.wikipedia.org/wiki/M%C3%B6ller%E2%80%93Trumbore_intersection_algorithm
+#include "../Parallel/Parallel.hpp"
+#include "Intersections.hpp"
+
+namespace {
+const std::size_t triangles_per_block = 256;
+// Points classified by one parallel task of are_points_inside_model
+const std::size_t points_per_task = 1024;
+// Faces whose areas are summed by one parallel task of parallel_surface_area. Fixed, so the sum doesn't depend on the
+// number of threads
+const std::size_t faces_per_task = 1 << 14;
+// Partial sums of the areas of a block, added lane by lane so the compiler vectorises the additions
+const std::size_t area_lanes = 8;
+
+// First corner and the two edges from it of a block of triangles, one array per coordinate. The arrays are padded
+// for the intersection engine
+struct TriangleBlock {
+  static constexpr std::size_t size = triangles_per_block + IntersectionEngine::padding;
+
+  alignas(64) float v0[3][size] = {};
+  alignas(64) float e1[3][size] = {};
+  alignas(64) float e2[3][size] = {};
+
+  IntersectionEngine::TriangleArrays arrays() const {
+    return {{v0[0], v0[1], v0[2]}, {e1[0], e1[1], e1[2]}, {e2[0], e2[1], e2[2]}};
+  }
+};
+
+// Gathers the faces [first, first + count) of model, count is at most triangles_per_block
+void gather(const Model& model,
+            const PositionArrays& positions,
+            std::size_t first,
+            std::size_t count,
+            TriangleBlock& block) {
+  const std::array<const float*, 3> coordinates = {positions.x(), positions.y(), positions.z()};
+
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto& face = model.triangular_faces[first + i];
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      const float a     = coordinates[axis][face[0].x];
+      block.v0[axis][i] = a;
+      block.e1[axis][i] = coordinates[axis][face[1].x] - a;
+      block.e2[axis][i] = coordinates[axis][face[2].x] - a;
+    }
+  }
+}
+
+// The same with the positions of model
+void gather(const Model& model, std::size_t first, std::size_t count, TriangleBlock& block) {
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto& face   = model.triangular_faces[first + i];
+    const glm::vec4& a = model.positions[face[0].x];
+    const glm::vec4& b = model.positions[face[1].x];
+    const glm::vec4& c = model.positions[face[2].x];
+    for (int axis = 0; axis < 3; ++axis) {
+      block.v0[axis][i] = a[axis];
+      block.e1[axis][i] = b[axis] - a[axis];
+      block.e2[axis][i] = c[axis] - a[axis];
+    }
+  }
+}
+
+// Sums values in a fixed tree of additions, so the rounding error grows with the logarithm of count, not with count
+double pairwise_sum(const double* values, std::size_t count) {
+  if (count <= 8) {
+    double sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      sum += values[i];
+    }
+    return sum;
+  }
+
+  const std::size_t half = count / 2;
+  return pairwise_sum(values, half) + pairwise_sum(values + half, count - half);
+}
+
+// Area of the faces [first, first + count) of model in double, count is at most faces_per_task
+double area_of_faces(const Model& model, std::size_t first, std::size_t count) {
+  TriangleBlock block;
+  alignas(64) float areas[triangles_per_block];
+  double block_sums[faces_per_task / triangles_per_block];
+  std::size_t num_blocks = 0;
+
+  for (std::size_t gathered = 0; gathered < count; gathered += triangles_per_block) {
+    const std::size_t size = std::min(triangles_per_block, count - gathered);
+    gather(model, first + gathered, size, block);
+
+    // Same operations as area_of_triangle, on all the triangles of the block at once
+    for (std::size_t i = 0; i < size; ++i) {
+      const float abx = block.e1[0][i], aby = block.e1[1][i], abz = block.e1[2][i];
+      const float acx = block.e2[0][i], acy = block.e2[1][i], acz = block.e2[2][i];
+
+      const float nx = aby * acz - abz * acy;
+      const float ny = abz * acx - abx * acz;
+      const float nz = abx * acy - aby * acx;
+      areas[i]       = std::sqrt(nx * nx + ny * ny + nz * nz) / 2.0f;
+    }
+
+    const std::size_t padded_size = (size + area_lanes - 1) / area_lanes * area_lanes;
+    std::fill(areas + size, areas + padded_size, 0.0f);
+
+    double lanes[area_lanes] = {};
+    for (std::size_t i = 0; i < padded_size; i += area_lanes) {
+      for (std::size_t lane = 0; lane < area_lanes; ++lane) {
+        lanes[lane] += areas[i + lane];
+      }
+    }
+    block_sums[num_blocks++] = pairwise_sum(lanes, area_lanes);
+  }
+
+  return pairwise_sum(block_sums, num_blocks);
+}
+
+// Spreads the lowest 16 bits of value, so there is a zero bit between each of them
+std::uint32_t spread_bits(std::uint32_t value) {
+  value = (value | (value << 8)) & 0x00ff00ffu;
+  value = (value | (value << 4)) & 0x0f0f0f0fu;
+  value = (value | (value << 2)) & 0x33333333u;
+  value = (value | (value << 1)) & 0x55555555u;
+  return value;
+}
+
+// Indices of the points sorted by the Morton curve of their projections on a plane perpendicular to direction. Rays
+// in the direction from consecutive points are close and parallel, rays from points on the same line are the same
+std::vector<std::uint32_t> ray_order(const glm::vec3* points, std::size_t count, const glm::vec3& direction) {
+  // Two axes of the plane, the first one is perpendicular to the direction and the coordinate axis least aligned with it
+  const glm::vec3 magnitude = glm::abs(direction);
+  glm::vec3 least_aligned{0};
+  least_aligned[magnitude.x <= magnitude.y && magnitude.x <= magnitude.z ? 0 : magnitude.y <= magnitude.z ? 1 : 2] = 1;
+  const glm::vec3 first_axis  = glm::normalize(glm::cross(direction, least_aligned));
+  const glm::vec3 second_axis = glm::normalize(glm::cross(direction, first_axis));
+
+  std::vector<glm::vec2> projections(count);
+  glm::vec2 min{std::numeric_limits<float>::infinity()}, max{-std::numeric_limits<float>::infinity()};
+  for (std::size_t i = 0; i < count; ++i) {
+    projections[i] = {glm::dot(points[i], first_axis), glm::dot(points[i], second_axis)};
+    min            = glm::min(min, projections[i]);
+    max            = glm::max(max, projections[i]);
+  }
+
+  // 16 bits per axis. Non-finite projections (zero direction, infinite points) end up in the first cell
+  const glm::vec2 extent = max - min;
+  const glm::vec2 scale{extent.x > 0 && extent.x < std::numeric_limits<float>::infinity() ? 65535 / extent.x : 0,
+                        extent.y > 0 && extent.y < std::numeric_limits<float>::infinity() ? 65535 / extent.y : 0};
+
+  std::vector<std::uint64_t> keys(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const glm::vec2 cell = glm::clamp((projections[i] - min) * scale, glm::vec2{0}, glm::vec2{65535});
+    const std::uint64_t code =
+        spread_bits(cell.x == cell.x ? static_cast<std::uint32_t>(cell.x) : 0) |
+        spread_bits(cell.y == cell.y ? static_cast<std::uint32_t>(cell.y) : 0) << 1;
+    keys[i] = code << 32 | i;
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<std::uint32_t> order(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    order[i] = static_cast<std::uint32_t>(keys[i]);
+  }
+  return order;
+}
+
+// Runs function(block, count) for the blocks of faces of model
+template <class Function>
+void for_each_block(const Model& model, const PositionArrays& positions, Function&& function) {
+  TriangleBlock block;
+
+  for (std::size_t first = 0; first < model.triangular_faces.size(); first += triangles_per_block) {
+    const std::size_t count = std::min(triangles_per_block, model.triangular_faces.size() - first);
+    gather(model, positions, first, count, block);
+    function(block, count);
+  }
+}
+}  // namespace
+
 bool RayIntersectsTriangle(const glm::vec3& rayOrigin,
                            const glm::vec3& rayVector,
                            const std::array<glm::vec3, 3>& inTriangle,
                            glm::vec3& outIntersectionPoint) {
-  const float EPSILON = 0.0000001;
-  glm::vec3 vertex0   = inTriangle[0];
-  glm::vec3 vertex1   = inTriangle[1];
-  glm::vec3 vertex2   = inTriangle[2];
-  glm::vec3 edge1, edge2, h, s, q;
-  float a, f, u, v;
-  edge1 = vertex1 - vertex0;
-  edge2 = vertex2 - vertex0;
-  h     = glm::cross(rayVector, edge2);
-  a     = glm::dot(edge1, h);
-  if (a > -EPSILON && a < EPSILON) return false;  // This ray is parallel to this triangle.
-  f = 1.0 / a;
-  s = rayOrigin - vertex0;
-  u = f * glm::dot(s, h);
-  if (u < 0.0 || u > 1.0) return false;
-  q = glm::cross(s, edge1);
-  v = f * glm::dot(rayVector, q);
-  if (v < 0.0 || u + v > 1.0) return false;
-  // At this stage we can compute t to find out where the intersection point is on the line.
-  float t = f * glm::dot(edge2, q);
-  if (t > EPSILON && t < 1 / EPSILON)  // ray intersection
-  {
-    outIntersectionPoint = rayOrigin + rayVector * t;
-    return true;
-  } else  // This means that there is a line intersection but not a ray intersection.
+  const glm::vec3 edge1 = inTriangle[1] - inTriangle[0];
+  const glm::vec3 edge2 = inTriangle[2] - inTriangle[0];
+
+  const DirectionTerms terms = direction_terms(rayVector, edge2, edge1);
+
+  float t;
+  if (!ray_hits_triangle(rayOrigin, rayVector, terms, inTriangle[0], edge1, edge2, t)) {
     return false;
+  }
+
+  outIntersectionPoint = rayOrigin + rayVector * t;
+  return true;
 }
 
 int num_of_intersections(const glm::vec3& rayOrigin, const glm::vec3& rayVector, const Model& model) {
@@ -92,3 +256,148 @@ void transform(Model& model, const glm::mat4& transformation) {
     normal = glm::vec3(glm::vec4(normal, 1) * inverse_transpose_transform);
   }
 }
+
+int num_of_intersections(const glm::vec3& rayOrigin,
+                         const glm::vec3& rayVector,
+                         const Model& model,
+                         const PositionArrays& positions) {
+  const IntersectionEngine& engine = IntersectionEngine::best();
+  int num_of_intersections         = 0;
+
+  for_each_block(model, positions, [&](const TriangleBlock& block, std::size_t count) {
+    num_of_intersections += engine.count(rayOrigin, rayVector, block.arrays(), count);
+  });
+
+  return num_of_intersections;
+}
+
+bool is_point_inside_model(const glm::vec3& point, const Model& model, const PositionArrays& positions) {
+  return num_of_intersections(point, glm::vec3{1}, model, positions) % 2 != 0;
+}
+
+float surface_area(const Model& model, const PositionArrays& positions) {
+  float area = 0;
+  float areas[triangles_per_block];
+
+  for_each_block(model, positions, [&](const TriangleBlock& block, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      const float abx = block.e1[0][i], aby = block.e1[1][i], abz = block.e1[2][i];
+      const float acx = block.e2[0][i], acy = block.e2[1][i], acz = block.e2[2][i];
+
+      const float nx = aby * acz - abz * acy;
+      const float ny = abz * acx - abx * acz;
+      const float nz = abx * acy - aby * acx;
+      areas[i]       = std::sqrt(nx * nx + ny * ny + nz * nz) / 2.0f;
+    }
+
+    // Summed in the order of the faces, like surface_area of the model
+    for (std::size_t i = 0; i < count; ++i) {
+      area += areas[i];
+    }
+  });
+
+  return area;
+}
+
+int num_of_intersections(const glm::vec3& rayOrigin, const glm::vec3& rayVector, const BVH& bvh) {
+  return bvh.num_of_intersections(rayOrigin, rayVector);
+}
+
+bool is_point_inside_model(const glm::vec3& point, const BVH& bvh) {
+  return num_of_intersections(point, glm::vec3{1}, bvh) % 2 != 0;
+}
+
+std::vector<std::uint8_t> are_points_inside_model(const glm::vec3* points,
+                                                  std::size_t count,
+                                                  const BVH& bvh,
+                                                  std::size_t num_threads) {
+  std::vector<std::uint8_t> inside(count, 0);
+  if (count == 0) {
+    return inside;
+  }
+
+  const glm::vec3 direction{1};
+  const std::vector<std::uint32_t> order = ray_order(points, count, direction);
+  parallel_for((count + points_per_task - 1) / points_per_task, num_threads, [&](std::size_t task) {
+    const std::size_t first = task * points_per_task;
+    const std::size_t size  = std::min(points_per_task, count - first);
+
+    // Consecutive points in this order make coherent packets of rays
+    glm::vec3 origins[points_per_task];
+    int counts[points_per_task];
+    for (std::size_t i = 0; i < size; ++i) {
+      origins[i] = points[order[first + i]];
+    }
+
+    bvh.num_of_intersections(origins, size, direction, counts);
+    for (std::size_t i = 0; i < size; ++i) {
+      inside[order[first + i]] = counts[i] % 2 != 0;
+    }
+  });
+
+  return inside;
+}
+
+std::vector<std::uint8_t> are_points_inside_model(const std::vector<glm::vec3>& points,
+                                                  const Model& model,
+                                                  std::size_t num_threads) {
+  return are_points_inside_model(points.data(), points.size(), BVH{model, num_threads}, num_threads);
+}
+
+float surface_area(const Model& model, const CompactFaces& faces) {
+  return std::visit(
+      [&](const auto& alternative) {
+        float area = 0;
+        for (const auto& face : alternative.positions) {
+          area += area_of_triangle({glm::vec3{model.positions[face[0]]},
+                                    glm::vec3{model.positions[face[1]]},
+                                    glm::vec3{model.positions[face[2]]}});
+        }
+        return area;
+      },
+      faces);
+}
+
+void transform(PositionArrays& positions, const glm::mat4& m) {
+  if (m[0][3] != 0 || m[1][3] != 0 || m[2][3] != 0 || m[3][3] != 1) {
+    positions.add_w();
+  }
+
+  float* x = positions.x();
+  float* y = positions.y();
+  float* z = positions.z();
+
+  // Same order of operations as glm's matrix * vector
+  if (!positions.has_w()) {
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      const float px = x[i], py = y[i], pz = z[i];
+      x[i]           = (m[0][0] * px + m[1][0] * py) + (m[2][0] * pz + m[3][0]);
+      y[i]           = (m[0][1] * px + m[1][1] * py) + (m[2][1] * pz + m[3][1]);
+      z[i]           = (m[0][2] * px + m[1][2] * py) + (m[2][2] * pz + m[3][2]);
+    }
+    return;
+  }
+
+  float* w = positions.w();
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    const float px = x[i], py = y[i], pz = z[i], pw = w[i];
+    x[i]           = (m[0][0] * px + m[1][0] * py) + (m[2][0] * pz + m[3][0] * pw);
+    y[i]           = (m[0][1] * px + m[1][1] * py) + (m[2][1] * pz + m[3][1] * pw);
+    z[i]           = (m[0][2] * px + m[1][2] * py) + (m[2][2] * pz + m[3][2] * pw);
+    w[i]           = (m[0][3] * px + m[1][3] * py) + (m[2][3] * pz + m[3][3] * pw);
+  }
+}
+
+double parallel_surface_area(const Model& model, std::size_t num_threads) {
+  const std::size_t num_faces = model.triangular_faces.size();
+  const std::size_t num_tasks = (num_faces + faces_per_task - 1) / faces_per_task;
+
+  // The sum of every task is stored and added in the same order afterwards, whichever thread computed it
+  std::vector<double> sums(num_tasks);
+  parallel_for(num_tasks, num_threads, [&](std::size_t task) {
+    const std::size_t first = task * faces_per_task;
+    sums[task]              = area_of_faces(model, first, std::min(faces_per_task, num_faces - first));
+  });
+
+  return pairwise_sum(sums.data(), sums.size());
+}
@@ -2,10 +2,16 @@
 #define COMPUTATIONS_COMPUTATIONS_HPP
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 #include <glm/glm.hpp>
 
+#include "../Types/CompactFaces.hpp"
 #include "../Types/Model.hpp"
+#include "../Types/PositionArrays.hpp"
+#include "BVH.hpp"
 
 // Computes if a ray intersects with a triangle
 bool RayIntersectsTriangle(const glm::vec3& rayOrigin,
@@ -27,4 +33,44 @@ float surface_area(const Model& model);
 
 void transform(Model& model, const glm::mat4& transformation);
 
+// The same computations with the positions taken from positions instead of model.positions (the faces are still the
+// ones of model). The triangles are gathered in blocks into arrays of coordinates, and the kernels run over the arrays
+// without branches, so the compiler vectorises them. The results are the same as the ones of the functions above
+int num_of_intersections(const glm::vec3& rayOrigin,
+                         const glm::vec3& rayVector,
+                         const Model& model,
+                         const PositionArrays& positions);
+bool is_point_inside_model(const glm::vec3& point, const Model& model, const PositionArrays& positions);
+float surface_area(const Model& model, const PositionArrays& positions);
+
+// The same counts with a BVH built from the model, so only the triangles near the ray are tested. Build the BVH once
+// and use it for all the queries on the model
+int num_of_intersections(const glm::vec3& rayOrigin, const glm::vec3& rayVector, const BVH& bvh);
+bool is_point_inside_model(const glm::vec3& point, const BVH& bvh);
+
+// is_point_inside_model for count points at once: 1 for the points inside, 0 for the others, in the order of points
+// The points are sorted along a Morton curve of their projections on the plane perpendicular to the rays first, so
+// consecutive points cast close, parallel rays, which are traced in packets. The sorted points are split between at
+// most num_threads threads (0 means all hardware threads)
+std::vector<std::uint8_t> are_points_inside_model(const glm::vec3* points,
+                                                  std::size_t count,
+                                                  const BVH& bvh,
+                                                  std::size_t num_threads = 0);
+// Builds a BVH for the queries. Build one and use the overload above to reuse it for more batches
+std::vector<std::uint8_t> are_points_inside_model(const std::vector<glm::vec3>& points,
+                                                  const Model& model,
+                                                  std::size_t num_threads = 0);
+
+// Surface area of model with faces instead of model.triangular_faces, with a loop for each alternative. The result
+// is the same as the one of surface_area(model)
+float surface_area(const Model& model, const CompactFaces& faces);
+
+// Surface area of model summed in double, with at most num_threads threads (0 means all hardware threads). The faces
+// are split into fixed blocks, whose areas are computed in vectorised loops and added pairwise, so the result is the
+// same for any number of threads and doesn't lose precision on large meshes like the float sum of surface_area(model)
+double parallel_surface_area(const Model& model, std::size_t num_threads = 0);
+
+// Transforms only the positions, an array for w is added if the transformation is projective
+void transform(PositionArrays& positions, const glm::mat4& transformation);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "FaceNormals.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../Parallel/Parallel.hpp"
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+// Both the scalar and the SIMD kernels compute exactly these operations in this order, so the results only differ if
+// the compiler contracts them differently (eg. into FMA instructions)
+void scalar_kernel(const FaceNormalEngine::TriangleArrays& triangles,
+                   std::size_t count,
+                   const std::array<float*, 3>& normals) {
+  for (std::size_t i = 0; i < count; ++i) {
+    const glm::vec3 a{triangles.a[0][i], triangles.a[1][i], triangles.a[2][i]};
+    const glm::vec3 b{triangles.b[0][i], triangles.b[1][i], triangles.b[2][i]};
+    const glm::vec3 c{triangles.c[0][i], triangles.c[1][i], triangles.c[2][i]};
+
+    const glm::vec3 normal = face_normal(a, b, c);
+    normals[0][i]          = normal.x;
+    normals[1][i]          = normal.y;
+    normals[2][i]          = normal.z;
+  }
+}
+
+#ifdef SIMD_X86
+void sse2_kernel(const FaceNormalEngine::TriangleArrays& triangles,
+                 std::size_t count,
+                 const std::array<float*, 3>& normals) {
+  const __m128 zero = _mm_setzero_ps();
+  std::size_t i     = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    const __m128 ax = _mm_loadu_ps(triangles.a[0] + i);
+    const __m128 ay = _mm_loadu_ps(triangles.a[1] + i);
+    const __m128 az = _mm_loadu_ps(triangles.a[2] + i);
+
+    const __m128 e1x = _mm_sub_ps(_mm_loadu_ps(triangles.b[0] + i), ax);
+    const __m128 e1y = _mm_sub_ps(_mm_loadu_ps(triangles.b[1] + i), ay);
+    const __m128 e1z = _mm_sub_ps(_mm_loadu_ps(triangles.b[2] + i), az);
+    const __m128 e2x = _mm_sub_ps(_mm_loadu_ps(triangles.c[0] + i), ax);
+    const __m128 e2y = _mm_sub_ps(_mm_loadu_ps(triangles.c[1] + i), ay);
+    const __m128 e2z = _mm_sub_ps(_mm_loadu_ps(triangles.c[2] + i), az);
+
+    const __m128 nx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+    const __m128 ny = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+    const __m128 nz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+
+    const __m128 length =
+        _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz)));
+    // Degenerate triangles would divide by zero, they get a zero normal instead
+    const __m128 valid = _mm_cmpgt_ps(length, zero);
+
+    _mm_storeu_ps(normals[0] + i, _mm_and_ps(valid, _mm_div_ps(nx, length)));
+    _mm_storeu_ps(normals[1] + i, _mm_and_ps(valid, _mm_div_ps(ny, length)));
+    _mm_storeu_ps(normals[2] + i, _mm_and_ps(valid, _mm_div_ps(nz, length)));
+  }
+
+  const FaceNormalEngine::TriangleArrays rest = {
+      {triangles.a[0] + i, triangles.a[1] + i, triangles.a[2] + i},
+      {triangles.b[0] + i, triangles.b[1] + i, triangles.b[2] + i},
+      {triangles.c[0] + i, triangles.c[1] + i, triangles.c[2] + i},
+  };
+  scalar_kernel(rest, count - i, {normals[0] + i, normals[1] + i, normals[2] + i});
+}
+
+__attribute__((target("avx2"))) void avx2_kernel(const FaceNormalEngine::TriangleArrays& triangles,
+                                                 std::size_t count,
+                                                 const std::array<float*, 3>& normals) {
+  const __m256 zero = _mm256_setzero_ps();
+  std::size_t i     = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    const __m256 ax = _mm256_loadu_ps(triangles.a[0] + i);
+    const __m256 ay = _mm256_loadu_ps(triangles.a[1] + i);
+    const __m256 az = _mm256_loadu_ps(triangles.a[2] + i);
+
+    const __m256 e1x = _mm256_sub_ps(_mm256_loadu_ps(triangles.b[0] + i), ax);
+    const __m256 e1y = _mm256_sub_ps(_mm256_loadu_ps(triangles.b[1] + i), ay);
+    const __m256 e1z = _mm256_sub_ps(_mm256_loadu_ps(triangles.b[2] + i), az);
+    const __m256 e2x = _mm256_sub_ps(_mm256_loadu_ps(triangles.c[0] + i), ax);
+    const __m256 e2y = _mm256_sub_ps(_mm256_loadu_ps(triangles.c[1] + i), ay);
+    const __m256 e2z = _mm256_sub_ps(_mm256_loadu_ps(triangles.c[2] + i), az);
+
+    const __m256 nx = _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e1z, e2y));
+    const __m256 ny = _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e1x, e2z));
+    const __m256 nz = _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e1y, e2x));
+
+    const __m256 length = _mm256_sqrt_ps(
+        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, nx), _mm256_mul_ps(ny, ny)), _mm256_mul_ps(nz, nz)));
+    const __m256 valid = _mm256_cmp_ps(length, zero, _CMP_GT_OQ);
+
+    _mm256_storeu_ps(normals[0] + i, _mm256_and_ps(valid, _mm256_div_ps(nx, length)));
+    _mm256_storeu_ps(normals[1] + i, _mm256_and_ps(valid, _mm256_div_ps(ny, length)));
+    _mm256_storeu_ps(normals[2] + i, _mm256_and_ps(valid, _mm256_div_ps(nz, length)));
+  }
+
+  // The tail is short, it's not worth switching between AVX and SSE code for it
+  const FaceNormalEngine::TriangleArrays rest = {
+      {triangles.a[0] + i, triangles.a[1] + i, triangles.a[2] + i},
+      {triangles.b[0] + i, triangles.b[1] + i, triangles.b[2] + i},
+      {triangles.c[0] + i, triangles.c[1] + i, triangles.c[2] + i},
+  };
+  scalar_kernel(rest, count - i, {normals[0] + i, normals[1] + i, normals[2] + i});
+}
+#endif
+}  // namespace
+
+glm::vec3 face_normal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+  const glm::vec3 e1 = b - a;
+  const glm::vec3 e2 = c - a;
+
+  const glm::vec3 normal{e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x};
+  const float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+
+  return length > 0 ? normal / length : glm::vec3{0};
+}
+
+glm::vec3 face_normal(const Model& model, const std::array<glm::ivec3, 3>& face) {
+  return face_normal(glm::vec3{model.positions[face[0].x]},
+                     glm::vec3{model.positions[face[1].x]},
+                     glm::vec3{model.positions[face[2].x]});
+}
+
+glm::vec3 triangle_normal(const Model& model, const std::array<glm::ivec3, 3>& face) {
+  const int normal_index = face[0].z;
+  if (normal_index >= 0 && static_cast<std::size_t>(normal_index) < model.normals.size()) {
+    return model.normals[normal_index];
+  }
+
+  return face_normal(model, face);
+}
+
+const FaceNormalEngine& FaceNormalEngine::best() {
+  static const FaceNormalEngine engine{Level::avx2};
+  return engine;
+}
+
+FaceNormalEngine::FaceNormalEngine(Level level) {
+  this->level = supported_simd_level(level);
+
+  switch (this->level) {
+#ifdef SIMD_X86
+    case Level::avx2:
+      kernel = avx2_kernel;
+      break;
+    case Level::sse2:
+      kernel = sse2_kernel;
+      break;
+#endif
+    default:
+      kernel = scalar_kernel;
+      break;
+  }
+}
+
+void FaceNormalEngine::compute(const Model& model, std::size_t first, std::size_t count, glm::vec3* normals) const {
+  compute_faces(
+      model, count, [&](std::size_t i) -> const auto& { return model.triangular_faces[first + i]; }, normals);
+}
+
+std::vector<glm::vec3> FaceNormalEngine::compute(const Model& model, std::size_t num_threads) const {
+  // Large enough blocks that handing them out costs nothing compared to computing them
+  const std::size_t block_size = 64 * gather_size;
+  const std::size_t num_faces  = model.triangular_faces.size();
+
+  std::vector<glm::vec3> normals(num_faces);
+
+  parallel_for((num_faces + block_size - 1) / block_size, num_threads, [&](std::size_t block) {
+    const std::size_t first = block * block_size;
+    compute(model, first, std::min(block_size, num_faces - first), normals.data() + first);
+  });
+
+  return normals;
+}
+
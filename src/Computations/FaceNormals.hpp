@@ -0,0 +1,101 @@
+#ifndef COMPUTATIONS_FACE_NORMALS_HPP
+#define COMPUTATIONS_FACE_NORMALS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../Parallel/SimdLevel.hpp"
+#include "../Types/Model.hpp"
+
+// Unit normal of the triangle a, b, c (right hand rule on the vertex order). Degenerate triangles get a zero vector
+glm::vec3 face_normal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+
+// Facet normal of a face of model
+glm::vec3 face_normal(const Model& model, const std::array<glm::ivec3, 3>& face);
+
+// The normal of the first vertex of face, all 3 should have the same one. If there is none, its facet normal
+glm::vec3 triangle_normal(const Model& model, const std::array<glm::ivec3, 3>& face);
+
+// Computes the facet normals of many triangles at once. The corners are gathered into a structure of arrays, one array
+// per coordinate, so the cross products and normalisations run 4 or 8 triangles at a time
+// The implementation is picked at runtime based on the instruction sets of the CPU, with a plain scalar fallback
+class FaceNormalEngine {
+ public:
+  using Level = SimdLevel;
+
+  // Corners a, b and c of count triangles: x, y and z of every corner in a separate array
+  struct TriangleArrays {
+    std::array<const float*, 3> a;
+    std::array<const float*, 3> b;
+    std::array<const float*, 3> c;
+  };
+
+  // Engine using the widest instructions the CPU supports. Detected once, on the first call
+  static const FaceNormalEngine& best();
+
+  // Uses the given level, or the best supported one below it, if the CPU can't run it
+  explicit FaceNormalEngine(Level level);
+
+  Level get_level() const { return level; }
+
+  // Writes the x, y and z of the normal of each triangle into the arrays of normals
+  void compute(const TriangleArrays& triangles, std::size_t count, const std::array<float*, 3>& normals) const {
+    kernel(triangles, count, normals);
+  }
+
+  // Normals of the faces [first, first + count) of model
+  void compute(const Model& model, std::size_t first, std::size_t count, glm::vec3* normals) const;
+
+  // Normals of count faces of model, face(i) gives the i-th one in the layout of Model::triangular_faces. For faces
+  // stored in another form, like CompactFaces
+  template <class Faces>
+  void compute_faces(const Model& model, std::size_t count, Faces&& face, glm::vec3* normals) const;
+
+  // Normals of all faces of model, in the order of model.triangular_faces. Uses at most num_threads threads (0 means
+  // all hardware threads)
+  std::vector<glm::vec3> compute(const Model& model, std::size_t num_threads = 0) const;
+
+
+ private:
+  // Triangles gathered into the structure of arrays at a time, small enough for the arrays to stay in the L1 cache
+  static constexpr std::size_t gather_size = 256;
+
+  Level level;
+  void (*kernel)(const TriangleArrays&, std::size_t, const std::array<float*, 3>&);
+};
+
+template <class Faces>
+void FaceNormalEngine::compute_faces(const Model& model, std::size_t count, Faces&& face, glm::vec3* normals) const {
+  // x, y and z of the corners a, b and c, then x, y and z of the normals
+  alignas(32) float arrays[12][gather_size];
+  const TriangleArrays triangles = {
+      {arrays[0], arrays[1], arrays[2]}, {arrays[3], arrays[4], arrays[5]}, {arrays[6], arrays[7], arrays[8]}};
+  const std::array<float*, 3> result = {arrays[9], arrays[10], arrays[11]};
+
+  for (std::size_t gathered = 0; gathered < count; gathered += gather_size) {
+    const std::size_t size = std::min(gather_size, count - gathered);
+
+    for (std::size_t i = 0; i < size; ++i) {
+      const std::array<glm::ivec3, 3>& corners = face(gathered + i);
+
+      for (std::size_t corner = 0; corner < 3; ++corner) {
+        const glm::vec4& position = model.positions[corners[corner].x];
+        arrays[3 * corner][i]     = position.x;
+        arrays[3 * corner + 1][i] = position.y;
+        arrays[3 * corner + 2][i] = position.z;
+      }
+    }
+
+    kernel(triangles, size, result);
+
+    for (std::size_t i = 0; i < size; ++i) {
+      normals[gathered + i] = glm::vec3{result[0][i], result[1][i], result[2][i]};
+    }
+  }
+}
+
+#endif
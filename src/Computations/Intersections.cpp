@@ -0,0 +1,171 @@
+#include "Intersections.hpp"
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+int scalar_kernel(const glm::vec3& origin,
+                  const glm::vec3& direction,
+                  const IntersectionEngine::TriangleArrays& triangles,
+                  std::size_t count) {
+  int hits = 0;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    const glm::vec3 v0{triangles.v0[0][i], triangles.v0[1][i], triangles.v0[2][i]};
+    const glm::vec3 e1{triangles.e1[0][i], triangles.e1[1][i], triangles.e1[2][i]};
+    const glm::vec3 e2{triangles.e2[0][i], triangles.e2[1][i], triangles.e2[2][i]};
+
+    float t;
+    hits += ray_hits_triangle(origin, direction, direction_terms(direction, e2, e1), v0, e1, e2, t);
+  }
+
+  return hits;
+}
+
+#ifdef SIMD_X86
+int sse2_kernel(const glm::vec3& origin,
+                const glm::vec3& direction,
+                const IntersectionEngine::TriangleArrays& triangles,
+                std::size_t count) {
+  const __m128 epsilon     = _mm_set1_ps(intersection_epsilon);
+  const __m128 neg_epsilon = _mm_set1_ps(-intersection_epsilon);
+  const __m128 max_t       = _mm_set1_ps(1 / intersection_epsilon);
+  const __m128 zero        = _mm_setzero_ps();
+  const __m128 one         = _mm_set1_ps(1.0f);
+  const __m128 dx = _mm_set1_ps(direction.x), dy = _mm_set1_ps(direction.y), dz = _mm_set1_ps(direction.z);
+  const __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+  const __m128i lane = _mm_set_epi32(3, 2, 1, 0);
+
+  int hits = 0;
+  for (std::size_t i = 0; i < count; i += 4) {
+    const __m128 e1x = _mm_loadu_ps(triangles.e1[0] + i);
+    const __m128 e1y = _mm_loadu_ps(triangles.e1[1] + i);
+    const __m128 e1z = _mm_loadu_ps(triangles.e1[2] + i);
+    const __m128 e2x = _mm_loadu_ps(triangles.e2[0] + i);
+    const __m128 e2y = _mm_loadu_ps(triangles.e2[1] + i);
+    const __m128 e2z = _mm_loadu_ps(triangles.e2[2] + i);
+
+    const __m128 hx = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    const __m128 hy = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    const __m128 hz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    const __m128 a  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, hx), _mm_mul_ps(e1y, hy)), _mm_mul_ps(e1z, hz));
+    const __m128 f  = _mm_div_ps(one, a);
+
+    const __m128 sx = _mm_sub_ps(ox, _mm_loadu_ps(triangles.v0[0] + i));
+    const __m128 sy = _mm_sub_ps(oy, _mm_loadu_ps(triangles.v0[1] + i));
+    const __m128 sz = _mm_sub_ps(oz, _mm_loadu_ps(triangles.v0[2] + i));
+    const __m128 u =
+        _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, hx), _mm_mul_ps(sy, hy)), _mm_mul_ps(sz, hz)));
+
+    const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+    const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+    const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+    const __m128 v =
+        _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+    const __m128 t =
+        _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+
+    const __m128 parallel = _mm_and_ps(_mm_cmpgt_ps(a, neg_epsilon), _mm_cmplt_ps(a, epsilon));
+    const __m128 outside  = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(u, zero), _mm_cmpgt_ps(u, one)),
+                                     _mm_or_ps(_mm_cmplt_ps(v, zero), _mm_cmpgt_ps(_mm_add_ps(u, v), one)));
+    const __m128 in_range = _mm_and_ps(_mm_cmpgt_ps(t, epsilon), _mm_cmplt_ps(t, max_t));
+    // Lanes past count are padding
+    const __m128 valid =
+        _mm_castsi128_ps(_mm_cmplt_epi32(_mm_add_epi32(lane, _mm_set1_epi32(static_cast<int>(i))),
+                                         _mm_set1_epi32(static_cast<int>(count))));
+
+    const __m128 hit = _mm_and_ps(_mm_andnot_ps(_mm_or_ps(parallel, outside), in_range), valid);
+    hits += __builtin_popcount(_mm_movemask_ps(hit));
+  }
+
+  return hits;
+}
+
+__attribute__((target("avx2"))) int avx2_kernel(const glm::vec3& origin,
+                                                const glm::vec3& direction,
+                                                const IntersectionEngine::TriangleArrays& triangles,
+                                                std::size_t count) {
+  const __m256 epsilon     = _mm256_set1_ps(intersection_epsilon);
+  const __m256 neg_epsilon = _mm256_set1_ps(-intersection_epsilon);
+  const __m256 max_t       = _mm256_set1_ps(1 / intersection_epsilon);
+  const __m256 zero        = _mm256_setzero_ps();
+  const __m256 one         = _mm256_set1_ps(1.0f);
+  const __m256 dx = _mm256_set1_ps(direction.x), dy = _mm256_set1_ps(direction.y), dz = _mm256_set1_ps(direction.z);
+  const __m256 ox = _mm256_set1_ps(origin.x), oy = _mm256_set1_ps(origin.y), oz = _mm256_set1_ps(origin.z);
+  const __m256i lane = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+
+  int hits = 0;
+  for (std::size_t i = 0; i < count; i += 8) {
+    const __m256 e1x = _mm256_loadu_ps(triangles.e1[0] + i);
+    const __m256 e1y = _mm256_loadu_ps(triangles.e1[1] + i);
+    const __m256 e1z = _mm256_loadu_ps(triangles.e1[2] + i);
+    const __m256 e2x = _mm256_loadu_ps(triangles.e2[0] + i);
+    const __m256 e2y = _mm256_loadu_ps(triangles.e2[1] + i);
+    const __m256 e2z = _mm256_loadu_ps(triangles.e2[2] + i);
+
+    const __m256 hx = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+    const __m256 hy = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+    const __m256 hz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+    const __m256 a =
+        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, hx), _mm256_mul_ps(e1y, hy)), _mm256_mul_ps(e1z, hz));
+    const __m256 f = _mm256_div_ps(one, a);
+
+    const __m256 sx = _mm256_sub_ps(ox, _mm256_loadu_ps(triangles.v0[0] + i));
+    const __m256 sy = _mm256_sub_ps(oy, _mm256_loadu_ps(triangles.v0[1] + i));
+    const __m256 sz = _mm256_sub_ps(oz, _mm256_loadu_ps(triangles.v0[2] + i));
+    const __m256 u  = _mm256_mul_ps(
+        f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, hx), _mm256_mul_ps(sy, hy)), _mm256_mul_ps(sz, hz)));
+
+    const __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+    const __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+    const __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+    const __m256 v  = _mm256_mul_ps(
+        f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)));
+    const __m256 t = _mm256_mul_ps(
+        f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)));
+
+    const __m256 parallel =
+        _mm256_and_ps(_mm256_cmp_ps(a, neg_epsilon, _CMP_GT_OQ), _mm256_cmp_ps(a, epsilon, _CMP_LT_OQ));
+    const __m256 outside =
+        _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(u, zero, _CMP_LT_OQ), _mm256_cmp_ps(u, one, _CMP_GT_OQ)),
+                     _mm256_or_ps(_mm256_cmp_ps(v, zero, _CMP_LT_OQ),
+                                  _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_GT_OQ)));
+    const __m256 in_range =
+        _mm256_and_ps(_mm256_cmp_ps(t, epsilon, _CMP_GT_OQ), _mm256_cmp_ps(t, max_t, _CMP_LT_OQ));
+    // Lanes past count are padding
+    const __m256 valid = _mm256_castsi256_ps(_mm256_cmpgt_epi32(
+        _mm256_set1_epi32(static_cast<int>(count)), _mm256_add_epi32(lane, _mm256_set1_epi32(static_cast<int>(i)))));
+
+    const __m256 hit = _mm256_and_ps(_mm256_andnot_ps(_mm256_or_ps(parallel, outside), in_range), valid);
+    hits += __builtin_popcount(_mm256_movemask_ps(hit));
+  }
+
+  return hits;
+}
+#endif
+}  // namespace
+
+const IntersectionEngine& IntersectionEngine::best() {
+  static const IntersectionEngine engine{Level::avx2};
+  return engine;
+}
+
+IntersectionEngine::IntersectionEngine(Level level) {
+  this->level = supported_simd_level(level);
+
+  switch (this->level) {
+#ifdef SIMD_X86
+    case Level::avx2:
+      kernel = avx2_kernel;
+      break;
+    case Level::sse2:
+      kernel = sse2_kernel;
+      break;
+#endif
+    default:
+      kernel = scalar_kernel;
+      break;
+  }
+}
+
@@ -0,0 +1,104 @@
+#ifndef COMPUTATIONS_INTERSECTIONS_HPP
+#define COMPUTATIONS_INTERSECTIONS_HPP
+
+#include <array>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include "../Parallel/SimdLevel.hpp"
+
+// Rays closer than this to parallel to a triangle don't hit it, and neither do hits closer than this to the origin
+// (in lengths of the direction)
+constexpr float intersection_epsilon = 0.0000001f;
+// Hits at 1 / intersection_epsilon or further aren't counted either. This is a little more, rounding included, for
+// culling the boxes the ray only reaches beyond that
+constexpr float max_intersection_distance = 1.0001f / intersection_epsilon;
+
+// Terms of the Möller–Trumbore test that only depend on the direction of the ray and the edges of the triangle, so
+// rays in the same direction can share them
+struct DirectionTerms {
+  float hx, hy, hz;
+  // Determinant, and its inverse
+  float a, f;
+
+  // NaNs fail both comparisons, so a NaN determinant isn't parallel, the hit test rejects it instead
+  bool parallel() const { return a > -intersection_epsilon && a < intersection_epsilon; }
+};
+
+inline DirectionTerms direction_terms(const glm::vec3& direction, const glm::vec3& e2, const glm::vec3& e1) {
+  DirectionTerms terms;
+  terms.hx = direction.y * e2.z - direction.z * e2.y;
+  terms.hy = direction.z * e2.x - direction.x * e2.z;
+  terms.hz = direction.x * e2.y - direction.y * e2.x;
+  terms.a  = e1.x * terms.hx + e1.y * terms.hy + e1.z * terms.hz;
+  // In double, then rounded to float. A single division rounded twice gives the same float as dividing in float, so
+  // the SIMD kernels divide in float
+  terms.f = 1.0 / terms.a;
+  return terms;
+}
+
+// Möller–Trumbore test of the ray against the triangle with the first corner v0 and the edges e1 and e2 from it
+// Every condition is evaluated, so loops over it have no branches. t is set to the distance of the hit (in lengths of
+// the direction), even if there is none
+// Source: https://en.wikipedia.org/wiki/M%C3%B6ller%E2%80%93Trumbore_intersection_algorithm
+inline bool ray_hits_triangle(const glm::vec3& origin,
+                              const glm::vec3& direction,
+                              const DirectionTerms& terms,
+                              const glm::vec3& v0,
+                              const glm::vec3& e1,
+                              const glm::vec3& e2,
+                              float& t) {
+  const float sx = origin.x - v0.x, sy = origin.y - v0.y, sz = origin.z - v0.z;
+  const float u  = terms.f * (sx * terms.hx + sy * terms.hy + sz * terms.hz);
+
+  const float qx = sy * e1.z - sz * e1.y;
+  const float qy = sz * e1.x - sx * e1.z;
+  const float qz = sx * e1.y - sy * e1.x;
+  const float v  = terms.f * (direction.x * qx + direction.y * qy + direction.z * qz);
+  t              = terms.f * (e2.x * qx + e2.y * qy + e2.z * qz);
+
+  const bool outside = (u < 0.0f) | (u > 1.0f) | (v < 0.0f) | (u + v > 1.0f);
+  return !terms.parallel() & !outside & (t > intersection_epsilon) & (t < 1 / intersection_epsilon);
+}
+
+// Counts how many of many triangles a ray hits, 4 or 8 triangles at a time. The triangles are given by their first
+// corner v0 and the edges e1 = v1 - v0 and e2 = v2 - v0, every coordinate in a separate array
+// Every kernel computes the same operations in the same order as ray_hits_triangle, so the counts are the same
+// The implementation is picked at runtime based on the instruction sets of the CPU, with a plain scalar fallback
+class IntersectionEngine {
+ public:
+  using Level = SimdLevel;
+
+  struct TriangleArrays {
+    std::array<const float*, 3> v0;
+    std::array<const float*, 3> e1;
+    std::array<const float*, 3> e2;
+  };
+
+  // The arrays are read in whole groups of 8 triangles: padding more floats after the last triangle have to be
+  // readable. Their values don't matter, they are never counted
+  static constexpr std::size_t padding = 8;
+
+  // Engine using the widest instructions the CPU supports. Detected once, on the first call
+  static const IntersectionEngine& best();
+
+  // Uses the given level, or the best supported one below it, if the CPU can't run it
+  explicit IntersectionEngine(Level level);
+
+  Level get_level() const { return level; }
+
+  // Number of the count triangles hit by the ray
+  int count(const glm::vec3& origin,
+            const glm::vec3& direction,
+            const TriangleArrays& triangles,
+            std::size_t count) const {
+    return kernel(origin, direction, triangles, count);
+  }
+
+ private:
+  Level level;
+  int (*kernel)(const glm::vec3&, const glm::vec3&, const TriangleArrays&, std::size_t);
+};
+
+#endif
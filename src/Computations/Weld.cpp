@@ -0,0 +1,206 @@
+#include "Weld.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "../Parallel/Parallel.hpp"
+
+namespace {
+// Positions handled by one parallel task
+const std::size_t positions_per_task = 1 << 16;
+
+using Cell = std::array<std::int64_t, 3>;
+
+// Grid cells of size cell_size. The buckets of the 8 cells of an aligned 2x2x2 block are next to each other, only the
+// blocks are hashed. So the cells around a position are mostly in one or two blocks, and read from a few cache lines
+class Grid {
+ public:
+  Grid(float cell_size, std::size_t num_positions) : cell_size{cell_size} {
+    std::size_t size = 8;
+    while (size < num_positions) {
+      size *= 2;
+    }
+    mask = size - 1;
+  }
+
+  std::size_t num_buckets() const { return mask + 1; }
+
+  Cell cell(const glm::vec3& position) const {
+    Cell cell;
+    for (int i = 0; i < 3; ++i) {
+      // Clamped, so far away and non finite positions still get a cell
+      const double coordinate = std::floor(scaled(position[i]));
+      cell[i]                 = static_cast<std::int64_t>(std::max(-1e15, std::min(1e15, coordinate)));
+    }
+    return cell;
+  }
+
+  // -1 or 1 for each coordinate: the neighbouring cell closer to the position
+  Cell near_side(const glm::vec3& position, const Cell& cell) const {
+    Cell side;
+    for (int i = 0; i < 3; ++i) {
+      side[i] = scaled(position[i]) - static_cast<double>(cell[i]) < 0.5 ? -1 : 1;
+    }
+    return side;
+  }
+
+  std::uint32_t bucket(const Cell& cell) const {
+    std::uint64_t hash = static_cast<std::uint64_t>(cell[0] >> 1) * 0x9e3779b97f4a7c15ULL;
+    hash               = (hash ^ (hash >> 31) ^ static_cast<std::uint64_t>(cell[1] >> 1)) * 0xbf58476d1ce4e5b9ULL;
+    hash               = (hash ^ (hash >> 29) ^ static_cast<std::uint64_t>(cell[2] >> 1)) * 0x94d049bb133111ebULL;
+
+    const std::uint64_t cell_in_block = (cell[0] & 1) | (cell[1] & 1) << 1 | (cell[2] & 1) << 2;
+    return static_cast<std::uint32_t>(((hash ^ (hash >> 32)) << 3 | cell_in_block) & mask);
+  }
+
+ private:
+  double scaled(float coordinate) const { return static_cast<double>(coordinate) / cell_size; }
+
+  double cell_size;
+  std::size_t mask = 0;
+};
+
+struct SortedPosition {
+  glm::vec3 position;
+  std::uint32_t index;
+};
+
+bool within(const glm::vec3& a, const glm::vec3& b, float epsilon) {
+  const glm::vec3 difference = a - b;
+  return glm::dot(difference, difference) <= epsilon * epsilon;
+}
+}  // namespace
+
+std::size_t weld_positions(Model& model, float epsilon, std::size_t num_threads) {
+  epsilon = std::max(epsilon, 0.0f);
+
+  const std::size_t num_positions = model.positions.size();
+  const std::size_t num_tasks     = (num_positions + positions_per_task - 1) / positions_per_task;
+  const auto for_each_task        = [&](auto&& function) {
+    parallel_for(num_tasks, num_threads, [&](std::size_t task) {
+      const std::size_t first = task * positions_per_task;
+      function(task, first, std::min(first + positions_per_task, num_positions));
+    });
+  };
+
+  // Cells of size 2 * epsilon, so the positions within epsilon are in the cell of a position, or in the neighbouring
+  // cells on the side it's closer to
+  const Grid grid{epsilon > 0 ? 2 * epsilon : 1.0f, num_positions};
+  const std::vector<glm::vec4>& positions = model.positions;
+
+  // Counting sort of the positions by bucket. Positions of a bucket are in any order, the result doesn't depend on it
+  std::vector<std::uint32_t> buckets(num_positions);
+  // Value-initialized to 0
+  std::vector<std::atomic<std::uint32_t>> bucket_counts(grid.num_buckets());
+
+  for_each_task([&](std::size_t, std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      buckets[i] = grid.bucket(grid.cell(glm::vec3{positions[i]}));
+      bucket_counts[buckets[i]].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  std::vector<std::uint32_t> bucket_starts(grid.num_buckets() + 1, 0);
+  for (std::size_t bucket = 0; bucket < grid.num_buckets(); ++bucket) {
+    bucket_starts[bucket + 1] = bucket_starts[bucket] + bucket_counts[bucket].load(std::memory_order_relaxed);
+    // From here on, the next free place in the bucket
+    bucket_counts[bucket].store(bucket_starts[bucket], std::memory_order_relaxed);
+  }
+
+  // Positions in bucket order next to their index, so the positions of a bucket are read from one place
+  std::vector<SortedPosition> sorted(num_positions);
+  for_each_task([&](std::size_t, std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      const std::uint32_t place = bucket_counts[buckets[i]].fetch_add(1, std::memory_order_relaxed);
+      sorted[place]             = {glm::vec3{positions[i]}, static_cast<std::uint32_t>(i)};
+    }
+  });
+
+  // The first position within epsilon, searched in the 8 cells around each position. Buckets can hold other cells
+  // too, the distance check skips them. The positions are visited in bucket order, so the positions of a cell are
+  // next to each other and share the buckets around them
+  std::vector<std::uint32_t> parents(num_positions);
+  for_each_task([&](std::size_t, std::size_t first, std::size_t last) {
+    std::array<std::uint32_t, 8> neighbour_buckets;
+    std::size_t num_neighbour_buckets = 0;
+    Cell previous_cell, previous_side;
+
+    for (std::size_t k = first; k < last; ++k) {
+      const SortedPosition& current = sorted[k];
+      const Cell cell               = grid.cell(current.position);
+      const Cell side               = grid.near_side(current.position, cell);
+
+      if (k == first || cell != previous_cell || side != previous_side) {
+        num_neighbour_buckets = 0;
+        for (std::int64_t x = 0; x <= 1; ++x) {
+          for (std::int64_t y = 0; y <= 1; ++y) {
+            for (std::int64_t z = 0; z <= 1; ++z) {
+              const Cell neighbour       = {cell[0] + x * side[0], cell[1] + y * side[1], cell[2] + z * side[2]};
+              const std::uint32_t bucket = grid.bucket(neighbour);
+              const auto end             = neighbour_buckets.begin() + num_neighbour_buckets;
+              // Empty buckets are left out right away
+              if (bucket_starts[bucket] != bucket_starts[bucket + 1] &&
+                  std::find(neighbour_buckets.begin(), end, bucket) == end) {
+                neighbour_buckets[num_neighbour_buckets++] = bucket;
+              }
+            }
+          }
+        }
+        previous_cell = cell;
+        previous_side = side;
+      }
+
+      std::uint32_t parent = current.index;
+      for (std::size_t neighbour = 0; neighbour < num_neighbour_buckets; ++neighbour) {
+        const std::uint32_t bucket = neighbour_buckets[neighbour];
+        for (std::uint32_t j = bucket_starts[bucket]; j < bucket_starts[bucket + 1]; ++j) {
+          if (sorted[j].index < parent && within(sorted[j].position, current.position, epsilon)) {
+            parent = sorted[j].index;
+          }
+        }
+      }
+      parents[current.index] = parent;
+    }
+  });
+
+  // Parents come before their children, so one pass in order resolves the chains. The kept positions get their new
+  // indices in the same pass
+  std::vector<std::uint32_t>& new_indices = buckets;
+  std::size_t num_kept                    = 0;
+  for (std::size_t i = 0; i < num_positions; ++i) {
+    new_indices[i] = parents[i] == i ? num_kept++ : new_indices[parents[i]];
+  }
+
+  if (num_kept == num_positions) {
+    return 0;
+  }
+
+  std::vector<glm::vec4> kept_positions(num_kept);
+  for_each_task([&](std::size_t, std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      if (parents[i] == i) {
+        kept_positions[new_indices[i]] = positions[i];
+      }
+    }
+  });
+  model.positions = std::move(kept_positions);
+
+  const std::size_t num_faces      = model.triangular_faces.size();
+  const std::size_t num_face_tasks = (num_faces + positions_per_task - 1) / positions_per_task;
+  parallel_for(num_face_tasks, num_threads, [&](std::size_t task) {
+    const std::size_t last = std::min((task + 1) * positions_per_task, num_faces);
+    for (std::size_t face = task * positions_per_task; face < last; ++face) {
+      for (auto& corner : model.triangular_faces[face]) {
+        if (corner.x >= 0 && static_cast<std::size_t>(corner.x) < num_positions) {
+          corner.x = new_indices[corner.x];
+        }
+      }
+    }
+  });
+
+  return num_positions - num_kept;
+}
@@ -0,0 +1,16 @@
+#ifndef COMPUTATIONS_WELD_HPP
+#define COMPUTATIONS_WELD_HPP
+
+#include <cstddef>
+
+#include "../Types/Model.hpp"
+
+// Merges the positions of model that are at most epsilon apart (x, y and z, w is ignored) and points the faces to the
+// merged positions. Every position is merged into the first one within epsilon, so chains of close positions end up
+// as one, even if its ends are further apart. The kept positions stay in their original order, and the result doesn't
+// depend on the number of threads. An epsilon of 0 merges only identical positions
+// Close positions are found with a uniform grid of cells of size 2 * epsilon, so only the 8 cells nearest to a position
+// are searched. Uses at most num_threads threads (0 means all hardware threads). Returns the number of removed positions
+std::size_t weld_positions(Model& model, float epsilon, std::size_t num_threads = 0);
+
+#endif
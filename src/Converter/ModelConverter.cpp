@@ -15,13 +15,31 @@ bool ModelConverter::parse(const std::string& path) {
     return false;
   }
 
-  auto result = parser->parse(path);
+  if (printer) {
+    parser->set_required_attributes(printer->required_attributes());
+  }
+
+  // Parsers that pass the faces to a sink as fast as they parse them never store them in the larger layout
+  const bool compact = printer && printer->prints_compact_faces();
+  const bool stream  = compact && !parser->is_streaming_serial();
+
+  CompactFaceSink sink;
+  auto result = stream ? parser->parse(path, sink) : parser->parse(path);
   if (!result) {
     std::cerr << "Failed to parse file: " << path << "\n";
     return false;
   }
 
   model = std::make_unique<Model>(std::move(*result));
+  faces.reset();
+
+  if (stream) {
+    sink.finish();
+    faces = sink.take_faces();
+  } else if (compact) {
+    faces = compact_faces(*model);
+    decltype(model->triangular_faces)().swap(model->triangular_faces);
+  }
 
   return true;
 }
@@ -37,9 +55,36 @@ bool ModelConverter::print(const std::string& path) {
     return false;
   }
 
-  bool success = printer->print(*model, path);
+  bool success = faces ? printer->print_compact(*model, *faces, path) : printer->print(*model, path);
 
   return success;
 }
 
-const Model* ModelConverter::get_model() const { return model.get(); }
\ No newline at end of file
+bool ModelConverter::convert_streaming(const std::string& input_path, const std::string& output_path) {
+  if (!parser || !printer) {
+    std::cerr << "Please set a parser and a printer before trying to convert a file!\n";
+    return false;
+  }
+
+  auto sink = printer->open_sink(output_path);
+  if (!sink) {
+    return parse(input_path) && print(output_path);
+  }
+
+  parser->set_required_attributes(printer->required_attributes());
+
+  auto result = parser->parse(input_path, *sink);
+  if (!result) {
+    std::cerr << "Failed to parse file: " << input_path << "\n";
+    return false;
+  }
+
+  model = std::make_unique<Model>(std::move(*result));
+  faces.reset();
+
+  return sink->finish();
+}
+
+const Model* ModelConverter::get_model() const { return model.get(); }
+
+const CompactFaces* ModelConverter::get_compact_faces() const { return faces ? &*faces : nullptr; }
\ No newline at end of file
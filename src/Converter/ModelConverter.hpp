@@ -2,9 +2,11 @@
 #define CONVERTER_MODEL_CONVERTER_HPP
 
 #include <memory>
+#include <optional>
 
 #include "../Parser/ModelParser.hpp"
 #include "../Printer/ModelPrinter.hpp"
+#include "../Types/CompactFaces.hpp"
 #include "../Types/Model.hpp"
 
 // Converter class that has a parser and a printer, both can be changed freely.
@@ -15,16 +17,28 @@ class ModelConverter {
   void set_parser(std::unique_ptr<ModelParser> parser);
   void set_printer(std::unique_ptr<ModelPrinter> printer);
 
+  // Only the attributes the printer needs are parsed (if a printer is set), the model is parsed to be printed
+  // If the printer prints compact faces, the faces are kept as compact faces (6-24 bytes per triangle instead of 36)
+  // and model.triangular_faces stays empty. Parsers that stream as fast as they parse (see
+  // ModelParser::is_streaming_serial) fill them directly, the faces of the others are converted after parsing
   bool parse(const std::string& path);
   bool print(const std::string& path);
 
+  // Parses input_path and prints it to output_path without keeping the faces in memory: every triangle is printed as
+  // soon as it's parsed. The printer has to support sinks (see ModelPrinter::open_sink), otherwise this falls back to
+  // parse + print. Afterwards get_model returns the model without its faces
+  bool convert_streaming(const std::string& input_path, const std::string& output_path);
+
   const Model* get_model() const;
+  // The faces of the model if parse converted them to compact faces (then the model has none), otherwise nullptr
+  const CompactFaces* get_compact_faces() const;
 
  private:
   std::unique_ptr<ModelParser> parser   = nullptr;
   std::unique_ptr<ModelPrinter> printer = nullptr;
 
   std::unique_ptr<Model> model = nullptr;
+  std::optional<CompactFaces> faces;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,10 @@
+#include "Parallel.hpp"
+
+std::size_t resolve_thread_count(std::size_t num_threads) {
+  if (num_threads != 0) {
+    return num_threads;
+  }
+
+  // hardware_concurrency is allowed to return 0 if it can't tell
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
@@ -0,0 +1,50 @@
+#ifndef PARALLEL_PARALLEL_HPP
+#define PARALLEL_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Number of threads to use if num_threads were requested. 0 means one thread per hardware thread
+std::size_t resolve_thread_count(std::size_t num_threads);
+
+// Calls function(task) for every task in [0, num_tasks) using at most num_threads threads (0 means all hardware
+// threads). The calling thread works on the tasks too, and it returns when all of them are finished
+// Tasks are handed out one by one, so they can take different amounts of time, but they must not throw
+template <class Function>
+void parallel_for(std::size_t num_tasks, std::size_t num_threads, Function&& function);
+
+template <class Function>
+void parallel_for(std::size_t num_tasks, std::size_t num_threads, Function&& function) {
+  num_threads = std::min(resolve_thread_count(num_threads), num_tasks);
+
+  if (num_threads <= 1) {
+    for (std::size_t task = 0; task < num_tasks; ++task) {
+      function(task);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next_task{0};
+  auto worker = [&]() {
+    for (std::size_t task = next_task++; task < num_tasks; task = next_task++) {
+      function(task);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (std::size_t i = 0; i + 1 < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+
+  worker();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+#endif
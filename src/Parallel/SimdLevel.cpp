@@ -0,0 +1,35 @@
+#include "SimdLevel.hpp"
+
+bool is_simd_level_supported(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::scalar:
+      return true;
+#ifdef SIMD_X86
+    case SimdLevel::sse2:
+      return __builtin_cpu_supports("sse2");
+    case SimdLevel::avx2:
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return false;
+  }
+}
+
+SimdLevel supported_simd_level(SimdLevel level) {
+  while (!is_simd_level_supported(level)) {
+    level = static_cast<SimdLevel>(static_cast<int>(level) - 1);
+  }
+
+  return level;
+}
+
+const char* simd_level_name(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::avx2:
+      return "avx2";
+    case SimdLevel::sse2:
+      return "sse2";
+    default:
+      return "scalar";
+  }
+}
@@ -0,0 +1,21 @@
+#ifndef PARALLEL_SIMD_LEVEL_HPP
+#define PARALLEL_SIMD_LEVEL_HPP
+
+// SIMD kernels are only written for x86. SSE2 is part of x86-64, so the SSE2 kernels don't need any target
+// attributes, the AVX2 ones are compiled with __attribute__((target("avx2"))) and only run if the CPU supports it
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86
+#endif
+
+// Instruction sets the kernels picked at runtime are written for, from the narrowest to the widest
+enum class SimdLevel { scalar, sse2, avx2 };
+
+// Whether the CPU supports level and kernels for it are compiled for this architecture
+bool is_simd_level_supported(SimdLevel level);
+
+// level if it's supported, otherwise the widest supported one below it
+SimdLevel supported_simd_level(SimdLevel level);
+
+const char* simd_level_name(SimdLevel level);
+
+#endif
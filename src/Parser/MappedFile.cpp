@@ -0,0 +1,69 @@
+#include "MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+std::optional<MappedFile> MappedFile::open(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return std::nullopt;
+  }
+
+  struct stat file_info;
+  if (::fstat(fd, &file_info) != 0 || !S_ISREG(file_info.st_mode)) {
+    ::close(fd);
+    return std::nullopt;
+  }
+
+  const std::size_t size = static_cast<std::size_t>(file_info.st_size);
+
+  // mmap can't map 0 bytes, but an empty file is still a valid (empty) input
+  if (size == 0) {
+    ::close(fd);
+    return MappedFile{nullptr, 0};
+  }
+
+  void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the descriptor is closed
+  ::close(fd);
+
+  if (data == MAP_FAILED) {
+    return std::nullopt;
+  }
+
+  // Parsers walk the file front to back, so let the kernel read ahead aggressively and drop pages behind us
+  ::madvise(data, size, MADV_SEQUENTIAL);
+
+  return MappedFile{data, size};
+}
+
+MappedFile::MappedFile(void* data, std::size_t size) : data{data}, size{size} {}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data{std::exchange(other.data, nullptr)}, size{std::exchange(other.size, 0)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    data = std::exchange(other.data, nullptr);
+    size = std::exchange(other.size, 0);
+  }
+
+  return *this;
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+std::string_view MappedFile::view() const { return std::string_view{static_cast<const char*>(data), size}; }
+
+void MappedFile::unmap() {
+  if (data) {
+    ::munmap(data, size);
+    data = nullptr;
+    size = 0;
+  }
+}
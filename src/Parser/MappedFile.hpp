@@ -0,0 +1,35 @@
+#ifndef PARSER_MAPPED_FILE_HPP
+#define PARSER_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file. Only regular files can be mapped, anything else (pipes, stdin, character
+// devices) makes open return nullopt, so the caller can fall back to reading through a stream
+class MappedFile {
+ public:
+  static std::optional<MappedFile> open(const std::string& path);
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile();
+
+  // The bytes of the file. Valid as long as this object is alive
+  std::string_view view() const;
+
+ private:
+  MappedFile(void* data, std::size_t size);
+
+  void unmap();
+
+  void* data       = nullptr;
+  std::size_t size = 0;
+};
+
+#endif
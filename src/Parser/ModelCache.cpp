@@ -0,0 +1,193 @@
+#include "ModelCache.hpp"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#include "MappedFile.hpp"
+
+namespace {
+const std::array<char, 8> cache_magic = {'M', 'D', 'L', 'C', 'A', 'C', 'H', 'E'};
+// Has to be increased whenever the layout of the file or of the model types changes
+const std::uint32_t cache_version = 1;
+
+struct CacheHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t header_size;
+  ModelCacheKey key;
+  std::uint64_t num_positions;
+  std::uint64_t num_texture_coords;
+  std::uint64_t num_normals;
+  std::uint64_t num_faces;
+};
+
+using Face = std::array<glm::ivec3, 3>;
+
+template <class Element>
+void write_array(std::ofstream& out, const std::vector<Element>& elements) {
+  out.write(reinterpret_cast<const char*>(elements.data()), elements.size() * sizeof(Element));
+}
+
+// Copies count elements from the start of data into elements, and moves data past them
+template <class Element>
+bool read_array(std::string_view& data, std::uint64_t count, std::vector<Element>& elements) {
+  if (count > data.size() / sizeof(Element)) {
+    return false;
+  }
+
+  elements.resize(count);
+  std::memcpy(elements.data(), data.data(), count * sizeof(Element));
+  data.remove_prefix(count * sizeof(Element));
+
+  return true;
+}
+
+std::uint64_t rotate_left(std::uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+std::uint64_t mix(std::uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+
+  return value;
+}
+
+std::uint64_t read_word(const char* data) {
+  std::uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+}  // namespace
+
+bool ModelCacheKey::operator==(const ModelCacheKey& other) const {
+  return source_size == other.source_size && source_mtime_ns == other.source_mtime_ns &&
+         source_hash == other.source_hash && parser_variant == other.parser_variant;
+}
+
+std::optional<ModelCacheKey> make_model_cache_key(const std::string& path,
+                                                  std::string_view contents,
+                                                  std::uint64_t parser_variant) {
+  struct stat file_info;
+  if (::stat(path.c_str(), &file_info) != 0) {
+    return std::nullopt;
+  }
+
+  ModelCacheKey key;
+  key.source_size     = contents.size();
+  key.source_mtime_ns = static_cast<std::int64_t>(file_info.st_mtim.tv_sec) * 1000000000 + file_info.st_mtim.tv_nsec;
+  key.source_hash     = hash_bytes(contents);
+  key.parser_variant  = parser_variant;
+
+  return key;
+}
+
+std::string model_cache_path(const std::string& source_path) { return source_path + ".mcache"; }
+
+std::uint64_t hash_bytes(std::string_view data) {
+  const std::uint64_t prime = 0x9e3779b97f4a7c15ULL;
+
+  // Four independent lanes, so the multiplications of consecutive words don't wait for each other
+  std::array<std::uint64_t, 4> lanes = {prime, prime * 3, prime * 5, prime * 7};
+
+  const char* it = data.data();
+  for (std::size_t remaining = data.size(); remaining >= 32; remaining -= 32, it += 32) {
+    for (std::size_t lane = 0; lane < lanes.size(); ++lane) {
+      lanes[lane] = rotate_left(lanes[lane] ^ (read_word(it + lane * 8) * prime), 31) * prime;
+    }
+  }
+
+  std::uint64_t hash = data.size();
+  for (const auto lane : lanes) {
+    hash = mix(hash ^ lane);
+  }
+
+  for (const char* end = data.data() + data.size(); it != end; ++it) {
+    hash = (hash ^ static_cast<unsigned char>(*it)) * prime;
+  }
+
+  return mix(hash);
+}
+
+bool save_model_cache(const Model& model, const std::string& cache_path, const ModelCacheKey& key) {
+  // Unique per process and per call, so concurrent writers of the same cache never share a temporary file. The last
+  // rename wins, and every rename puts a complete file in place
+  static std::atomic<unsigned> num_saves{0};
+  const std::string temporary_path =
+      cache_path + "." + std::to_string(getpid()) + "." + std::to_string(num_saves.fetch_add(1)) + ".tmp";
+
+  {
+    std::ofstream out{temporary_path, std::ios::binary};
+    if (out.fail()) {
+      return false;
+    }
+
+    CacheHeader header{};
+    header.magic              = cache_magic;
+    header.version            = cache_version;
+    header.header_size        = sizeof(CacheHeader);
+    header.key                = key;
+    header.num_positions      = model.positions.size();
+    header.num_texture_coords = model.texture_coords.size();
+    header.num_normals        = model.normals.size();
+    header.num_faces          = model.triangular_faces.size();
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_array(out, model.positions);
+    write_array(out, model.texture_coords);
+    write_array(out, model.normals);
+    write_array(out, model.triangular_faces);
+
+    out.close();
+    if (out.fail()) {
+      std::remove(temporary_path.c_str());
+      return false;
+    }
+  }
+
+  return std::rename(temporary_path.c_str(), cache_path.c_str()) == 0;
+}
+
+std::optional<Model> load_model_cache(const std::string& cache_path, const ModelCacheKey& key) {
+  auto mapped_file = MappedFile::open(cache_path);
+  if (!mapped_file) {
+    return std::nullopt;
+  }
+
+  std::string_view data = mapped_file->view();
+
+  CacheHeader header;
+  if (data.size() < sizeof(header)) {
+    return std::nullopt;
+  }
+
+  std::memcpy(&header, data.data(), sizeof(header));
+  data.remove_prefix(sizeof(header));
+
+  if (header.magic != cache_magic || header.version != cache_version || header.header_size != sizeof(CacheHeader) ||
+      header.key != key) {
+    return std::nullopt;
+  }
+
+  Model model{0};
+  const bool complete = read_array(data, header.num_positions, model.positions) &&
+                        read_array(data, header.num_texture_coords, model.texture_coords) &&
+                        read_array(data, header.num_normals, model.normals) &&
+                        read_array(data, header.num_faces, model.triangular_faces) && data.empty();
+
+  if (!complete) {
+    std::cerr << "Ignoring damaged model cache " << cache_path << "\n";
+    return std::nullopt;
+  }
+
+  return model;
+}
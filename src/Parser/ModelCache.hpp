@@ -0,0 +1,43 @@
+#ifndef PARSER_MODEL_CACHE_HPP
+#define PARSER_MODEL_CACHE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "../Types/Model.hpp"
+
+// Identifies the source file a cached model was parsed from. A cache is only used if all of these match
+struct ModelCacheKey {
+  std::uint64_t source_size     = 0;
+  std::int64_t source_mtime_ns  = 0;
+  std::uint64_t source_hash     = 0;
+  // Parsers can produce different models from the same file depending on their settings, this tells them apart
+  std::uint64_t parser_variant = 0;
+
+  bool operator==(const ModelCacheKey& other) const;
+  bool operator!=(const ModelCacheKey& other) const { return !(*this == other); }
+};
+
+// Builds the key of the file at path, which has the given contents. Returns nullopt if the file can't be stat-ed
+std::optional<ModelCacheKey> make_model_cache_key(const std::string& path,
+                                                  std::string_view contents,
+                                                  std::uint64_t parser_variant);
+
+// The cache of "model.obj" is "model.obj.mcache", next to the source
+std::string model_cache_path(const std::string& source_path);
+
+// Fast non-cryptographic 64-bit hash of data, 32 bytes at a time
+std::uint64_t hash_bytes(std::string_view data);
+
+// Writes model into a compact binary file: a header with the key and the element counts, followed by the raw
+// positions, texture_coords, normals and triangular_faces arrays. The file is written under a temporary name and
+// renamed at the end, so a reader never sees a half written cache
+bool save_model_cache(const Model& model, const std::string& cache_path, const ModelCacheKey& key);
+
+// Maps the cache file and copies the arrays into a model. Returns nullopt if there is no cache, it's for a different
+// key or it's damaged
+std::optional<Model> load_model_cache(const std::string& cache_path, const ModelCacheKey& key);
+
+#endif
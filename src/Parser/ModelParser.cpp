@@ -1,11 +1,29 @@
 #include <fstream>
 #include <iostream>
 #include <optional>
+#include <streambuf>
 
 #include "../Types/Model.hpp"
+#include "MappedFile.hpp"
+#include "ModelCache.hpp"
 #include "ModelParser.hpp"
 
+namespace {
+// Read-only stream buffer over memory we don't own, so a buffer can be read as an std::istream without copying it
+class MemoryStreamBuf : public std::streambuf {
+ public:
+  explicit MemoryStreamBuf(std::string_view data) {
+    char* begin = const_cast<char*>(data.data());
+    setg(begin, begin, begin + data.size());
+  }
+};
+}  // namespace
+
 std::optional<Model> ModelParser::parse(const std::string& path) {
+  if (auto mapped_file = MappedFile::open(path); mapped_file) {
+    return cache_enabled ? parse_cached(path, mapped_file->view()) : parse_buffer(mapped_file->view());
+  }
+
   auto in = open_file(path);
   if (!in) {
     return std::nullopt;
@@ -14,6 +32,44 @@ std::optional<Model> ModelParser::parse(const std::string& path) {
   return parse_file(*in);
 }
 
+std::optional<Model> ModelParser::parse(const std::string& path, FaceSink& sink) {
+  auto model = parse(path);
+  if (!model) {
+    return std::nullopt;
+  }
+
+  for (const auto& face : model->triangular_faces) {
+    if (!sink.add_face(*model, face)) {
+      return std::nullopt;
+    }
+  }
+
+  model->triangular_faces.clear();
+  model->triangular_faces.shrink_to_fit();
+
+  return model;
+}
+
+std::optional<Model> ModelParser::parse_cached(const std::string& path, std::string_view data) {
+  const auto key = make_model_cache_key(path, data, cache_variant());
+  if (!key) {
+    return parse_buffer(data);
+  }
+
+  const std::string cache_path = model_cache_path(path);
+  if (auto model = load_model_cache(cache_path, *key); model) {
+    return model;
+  }
+
+  auto model = parse_buffer(data);
+  if (model && !save_model_cache(*model, cache_path, *key)) {
+    // Not being able to write the cache (e.g. a read-only directory) only costs time on the next run
+    std::cerr << "Could not write model cache " << cache_path << "\n";
+  }
+
+  return model;
+}
+
 std::optional<std::ifstream> ModelParser::open_file(const std::string& path) const {
   std::ifstream in{path};
 
@@ -24,3 +80,10 @@ std::optional<std::ifstream> ModelParser::open_file(const std::string& path) con
 
   return std::optional(std::move(in));
 }
+
+std::optional<Model> ModelParser::parse_buffer(std::string_view data) {
+  MemoryStreamBuf buffer{data};
+  std::istream in{&buffer};
+
+  return parse_file(in);
+}
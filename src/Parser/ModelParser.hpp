@@ -1,22 +1,58 @@
 #ifndef PARSER_MODEL_PARSER_HPP
 #define PARSER_MODEL_PARSER_HPP
 
+#include <cstdint>
 #include <fstream>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "../Types/FaceSink.hpp"
 #include "../Types/Model.hpp"
 
 class ModelParser {
  public:
+  // Regular files are memory mapped and handed to parse_buffer, everything else (pipes, stdin) is read with parse_file
   virtual std::optional<Model> parse(const std::string& path);
 
+  // Same as parse, but the faces are passed to sink instead of being stored in the returned model
+  // The default implementation parses the whole model first, parsers that can do better pass them as they go
+  virtual std::optional<Model> parse(const std::string& path, FaceSink& sink);
+
+  // Whether parse(path, sink) parses on fewer threads than parse(path), to pass the faces in order. Converters that
+  // could use either only pass the faces to a sink if it doesn't
+  virtual bool is_streaming_serial() const { return false; }
+
+  // When enabled, parse keeps a binary copy of every model it parses from a regular file next to the file (see
+  // ModelCache.hpp), and loads that copy instead of parsing again as long as the file hasn't changed
+  void set_cache_enabled(bool enabled) { cache_enabled = enabled; }
+  bool is_cache_enabled() const { return cache_enabled; }
+
+  // Attributes that aren't required may be left out of the parsed models. Everything is required by default
+  void set_required_attributes(const ModelAttributes& attributes) { required_attributes = attributes; }
+  const ModelAttributes& get_required_attributes() const { return required_attributes; }
+
   virtual ~ModelParser() {}
 
  protected:
   virtual std::optional<std::ifstream> open_file(const std::string& path) const;
   virtual std::optional<Model> parse_file(std::istream& in) = 0;
+
+  // Parses the whole input from memory. The default implementation wraps data in a stream and calls parse_file, so
+  // parsers only have to override it if they can do better than that
+  virtual std::optional<Model> parse_buffer(std::string_view data);
+
+  // Identifies the settings that change the parsed model, so models cached with other settings aren't reused
+  virtual std::uint64_t cache_variant() const {
+    return (required_attributes.texture_coords ? 1 : 0) | (required_attributes.normals ? 2 : 0);
+  }
+
+ private:
+  std::optional<Model> parse_cached(const std::string& path, std::string_view data);
+
+  bool cache_enabled = false;
+  ModelAttributes required_attributes;
 };
 
-#endif
\ No newline at end of file
+#endif
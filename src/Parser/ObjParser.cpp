@@ -1,19 +1,120 @@
 #include "ObjParser.hpp"
 
-std::optional<Model> ObjParser::parse_file(std::istream& in) {
-  Model model;
-  std::string line;
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
 
-  bool success        = true;
-  int lines_processed = 0;
+#include "../Parallel/Parallel.hpp"
+#include "StructuralScanner.hpp"
 
-  while (std::getline(in, line) && success) {
-    success = success && process_line(std::move(line), model);
-    line.clear();
-    ++lines_processed;
+void ObjParser::set_num_threads(std::size_t num_threads) { this->num_threads = num_threads; }
+
+std::optional<Model> ObjParser::parse(const std::string& path, FaceSink& sink) {
+  // A cached model already has all its faces, there is nothing left to stream
+  if (is_cache_enabled()) {
+    return ModelParser::parse(path, sink);
   }
 
+  face_sink   = &sink;
+  auto result = ModelParser::parse(path);
+  face_sink   = nullptr;
+
+  return result;
+}
+
+bool ObjParser::feed(std::string_view bytes) {
+  if (feed_failed) {
+    return false;
+  }
+
+  // Finish the line the previous piece ended in
+  if (!partial_line.empty()) {
+    const std::size_t line_end = bytes.find('\n');
+    if (line_end == std::string_view::npos) {
+      partial_line.append(bytes);
+      return true;
+    }
+
+    partial_line.append(bytes.substr(0, line_end));
+    bytes.remove_prefix(line_end + 1);
+
+    ++lines_fed;
+    feed_failed = !process_line(partial_line, fed_model);
+    partial_line.clear();
+  }
+
+  // Complete lines are parsed in place, only the unfinished one at the end is copied
+  const std::size_t last_newline = bytes.rfind('\n');
+  if (!feed_failed && last_newline != std::string_view::npos) {
+    feed_failed = !process_lines(bytes.substr(0, last_newline + 1), fed_model, lines_fed);
+    bytes.remove_prefix(last_newline + 1);
+  }
+
+  if (feed_failed) {
+    std::cerr << "Failed to read line " << lines_fed << "\n";
+    return false;
+  }
+
+  partial_line.assign(bytes);
+
+  return true;
+}
+
+std::optional<Model> ObjParser::finish() {
+  bool success = !feed_failed;
+
+  if (success && !partial_line.empty()) {
+    ++lines_fed;
+    success = process_line(partial_line, fed_model);
+
+    if (!success) {
+      std::cerr << "Failed to read line " << lines_fed << "\n";
+    }
+  }
+
+  Model model = std::move(fed_model);
+
+  fed_model = Model();
+  partial_line.clear();
+  lines_fed   = 0;
+  feed_failed = false;
+
   if (!success) {
+    return std::nullopt;
+  }
+
+  return model;
+}
+
+std::optional<Model> ObjParser::parse_file(std::istream& in) {
+  std::vector<char> buffer(64 * 1024);
+
+  while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0) {
+    if (!feed(std::string_view{buffer.data(), static_cast<std::size_t>(in.gcount())})) {
+      // Reset the parser for the next input
+      finish();
+      return std::nullopt;
+    }
+  }
+
+  return finish();
+}
+
+std::optional<Model> ObjParser::parse_buffer(std::string_view data) {
+  const std::size_t num_chunks = std::min(resolve_thread_count(num_threads), data.size() / min_chunk_size);
+  if (num_chunks > 1 && !face_sink) {
+    return parse_chunks(data, num_chunks);
+  }
+
+  ModelSize size = count_required_elements(data);
+  if (face_sink) {
+    size.triangular_faces = 0;
+  }
+
+  Model model{size};
+  std::size_t lines_processed = 0;
+
+  if (!process_lines(data, model, lines_processed)) {
     std::cerr << "Failed to read line " << lines_processed << "\n";
     return std::nullopt;
   }
@@ -21,11 +122,151 @@ std::optional<Model> ObjParser::parse_file(std::istream& in) {
   return model;
 }
 
-bool ObjParser::process_line(std::string&& line, Model& model) {
-  bool success          = true;
-  auto first_whitespace = line.find_first_of(' ');
+std::optional<Model> ObjParser::parse_chunks(std::string_view data, std::size_t num_chunks) {
+  // Every chunk ends right after a newline (except the last one), so no line is split between two chunks
+  std::vector<std::string_view> chunks;
+  chunks.reserve(num_chunks);
+
+  while (!data.empty()) {
+    const std::size_t target_size = data.size() / (num_chunks - chunks.size());
+    const std::size_t chunk_end   = chunks.size() + 1 == num_chunks ? data.size() : data.find('\n', target_size);
+    const std::size_t chunk_size  = std::min(chunk_end, data.size() - 1) + 1;
+
+    chunks.push_back(data.substr(0, chunk_size));
+    data.remove_prefix(chunk_size);
+  }
 
-  const std::string_view line_label{line.data(), first_whitespace};
+  struct Fragment {
+    Model model;
+    std::vector<RelativeCorner> relative_corners;
+    std::size_t lines_processed = 0;
+    bool success                = false;
+  };
+
+  std::vector<Fragment> fragments(chunks.size());
+
+  parallel_for(chunks.size(), chunks.size(), [&](std::size_t chunk) {
+    // Every chunk gets its own parser, so the line buffers aren't shared between threads
+    ObjParser chunk_parser{*this};
+    chunk_parser.relative_corners = &fragments[chunk].relative_corners;
+
+    Fragment& fragment = fragments[chunk];
+    fragment.model     = Model{count_required_elements(chunks[chunk])};
+    fragment.success   = chunk_parser.process_lines(chunks[chunk], fragment.model, fragment.lines_processed);
+  });
+
+  // Report the first bad line of the file, like the serial parser does
+  std::size_t lines_before_chunk = 0;
+  for (const auto& fragment : fragments) {
+    if (!fragment.success) {
+      std::cerr << "Failed to read line " << lines_before_chunk + fragment.lines_processed << "\n";
+      return std::nullopt;
+    }
+    lines_before_chunk += fragment.lines_processed;
+  }
+
+  // Relative indices only counted the attributes of their own chunk, everything before it has to be added
+  ModelSize size;
+  for (auto& fragment : fragments) {
+    const glm::ivec3 offset(size.positions, size.texture_coords, size.normals);
+    for (const auto& relative_corner : fragment.relative_corners) {
+      glm::ivec3& vertex = fragment.model.triangular_faces[relative_corner.face][relative_corner.corner];
+      for (glm::length_t i = 0; i < vertex.length(); ++i) {
+        if (relative_corner.components & (1 << i)) {
+          vertex[i] += offset[i];
+        }
+      }
+    }
+    fragment.relative_corners = {};
+
+    size.positions += fragment.model.positions.size();
+    size.texture_coords += fragment.model.texture_coords.size();
+    size.normals += fragment.model.normals.size();
+    size.triangular_faces += fragment.model.triangular_faces.size();
+  }
+
+  // Merged one attribute at a time, and every part is freed as soon as it's appended, so only one attribute is ever
+  // stored twice instead of the whole model
+  Model model{ModelSize{}};
+  const auto merge = [&](auto attribute, std::size_t count) {
+    auto& merged = model.*attribute;
+    merged.reserve(count);
+    for (auto& fragment : fragments) {
+      auto& part = fragment.model.*attribute;
+      merged.insert(merged.end(), part.begin(), part.end());
+      std::remove_reference_t<decltype(part)>().swap(part);
+    }
+  };
+
+  merge(&Model::positions, size.positions);
+  merge(&Model::texture_coords, size.texture_coords);
+  merge(&Model::normals, size.normals);
+  merge(&Model::triangular_faces, size.triangular_faces);
+
+  return model;
+}
+
+ModelSize ObjParser::count_required_elements(std::string_view data) const {
+  ModelSize size = count_elements(data);
+
+  if (!get_required_attributes().texture_coords) {
+    size.texture_coords = 0;
+  }
+  if (!get_required_attributes().normals) {
+    size.normals = 0;
+  }
+
+  return size;
+}
+
+bool ObjParser::process_lines(std::string_view data, Model& model, std::size_t& lines_processed) {
+  bool success = true;
+  LineScanner lines{data};
+
+  for (std::string_view line; success && lines.next(line);) {
+    success = process_line(line, model);
+    ++lines_processed;
+  }
+
+  return success;
+}
+
+ModelSize ObjParser::count_elements(std::string_view data) {
+  ModelSize size;
+  LineScanner lines{data};
+
+  // The line labels are checked the same way as in process_line: everything before the first space
+  for (std::string_view line; lines.next(line);) {
+    if (line.size() < 2) {
+      continue;
+    }
+
+    if (line[0] == 'v') {
+      if (line[1] == ' ') {
+        ++size.positions;
+      } else if (line.size() > 2 && line[2] == ' ') {
+        size.texture_coords += line[1] == 't';
+        size.normals += line[1] == 'n';
+      }
+    } else if (line[0] == 'f' && line[1] == ' ') {
+      const SplitView vertex_tokens{line.substr(2), ' ', true};
+      const auto vertices = static_cast<std::size_t>(std::distance(vertex_tokens.begin(), vertex_tokens.end()));
+
+      // Triangle fan: every vertex after the first two adds a triangle
+      size.triangular_faces += vertices > 2 ? vertices - 2 : 0;
+    }
+  }
+
+  return size;
+}
+
+bool ObjParser::process_line(std::string_view line, Model& model) {
+  bool success = true;
+  // Labels are one or two characters, a plain search is faster than setting up a vector one. A line can be only a
+  // label, then the rest of it is empty
+  const std::size_t first_whitespace = std::min(line.find(' '), line.size());
+
+  const std::string_view line_label = line.substr(0, first_whitespace);
 
   if (line_label == "v") {
     glm::vec4 position;
@@ -43,7 +284,7 @@ bool ObjParser::process_line(std::string&& line, Model& model) {
     }
   }
 
-  else if (line_label == "vt") {
+  else if (line_label == "vt" && get_required_attributes().texture_coords) {
     glm::vec3 texture;
     // Y and Z are optional, their default is 0
     texture.y       = 0.0;
@@ -60,7 +301,7 @@ bool ObjParser::process_line(std::string&& line, Model& model) {
     }
   }
 
-  else if (line_label == "vn") {
+  else if (line_label == "vn" && get_required_attributes().normals) {
     glm::vec3 normals;
     std::size_t min = 3;
     std::size_t max = 3;
@@ -75,40 +316,68 @@ bool ObjParser::process_line(std::string&& line, Model& model) {
   }
 
   else if (line_label == "f") {
-    auto result = process_faces(std::string_view{line.data() + first_whitespace, line.size() - first_whitespace});
-
-    if (!result) {
+    if (!process_faces(line.substr(first_whitespace), face_buffer)) {
       std::cerr << "Error processing faces\n";
       success = false;
-    } else if (result) {
+    } else {
       // Preprocess all indices: if they are negative, transform them based on positions/normals/textures size
       // If they are positive or 0, subtract 1 from each to convert 1-based indices to 0-based
       // If the index was 0 (indicates missing value), then it becomes -1, which is not valid for vector indexing
       // So in the final representation -1 will indicate missing values
-      for (auto& vec3 : *result) {
+      relative_buffer.assign(relative_corners ? face_buffer.size() : 0, 0);
+
+      for (std::size_t i = 0; i < face_buffer.size(); ++i) {
+        auto& vec3 = face_buffer[i];
         vec3 -= 1;
 
         // Positions can't be missing, so an x value of 0 is an error
         // Example line for this error: "f /2/3 /4/5 /8/23"
         if (vec3.x == -1) {
           return false;
-        } else if (vec3.x < -1) {
-          vec3.x = model.positions.size() + vec3.x + 1;
         }
 
-        // For y and z -1 is a valid value, it means they were missing, so we only check for samller than -1 values
-        if (vec3.y < -1) {
-          vec3.y = model.texture_coords.size() + vec3.y + 1;
+        // Indices of attributes that weren't read are dropped, like missing ones
+        if (!get_required_attributes().texture_coords) {
+          vec3.y = -1;
         }
-        if (vec3.z < -1) {
-          vec3.z = model.normals.size() + vec3.z + 1;
+        if (!get_required_attributes().normals) {
+          vec3.z = -1;
+        }
+
+        // For y and z -1 is a valid value, it means they were missing, so we only check for samller than -1 values
+        const glm::ivec3 sizes(model.positions.size(), model.texture_coords.size(), model.normals.size());
+        for (glm::length_t j = 0; j < vec3.length(); ++j) {
+          if (vec3[j] < -1) {
+            vec3[j] = sizes[j] + vec3[j] + 1;
+
+            if (relative_corners) {
+              relative_buffer[i] |= 1 << j;
+            }
+          }
         }
       }
 
       // Non-triangular faces are handled by using "triangle-fan": inedx 0 is always present
       // This way we can handle arbitrary number of face data on a single line
-      for (std::size_t i = 1; i + 1 < result->size(); ++i) {
-        model.triangular_faces.push_back({(*result)[0], (*result)[i], (*result)[i + 1]});
+      for (std::size_t i = 1; i + 1 < face_buffer.size(); ++i) {
+        if (relative_corners) {
+          const std::size_t face = model.triangular_faces.size();
+          const std::array<std::size_t, 3> corners{0, i, i + 1};
+
+          for (std::uint8_t corner = 0; corner < corners.size(); ++corner) {
+            if (relative_buffer[corners[corner]]) {
+              relative_corners->push_back({face, corner, relative_buffer[corners[corner]]});
+            }
+          }
+        }
+
+        if (face_sink) {
+          if (!face_sink->add_face(model, {face_buffer[0], face_buffer[i], face_buffer[i + 1]})) {
+            return false;
+          }
+        } else {
+          model.triangular_faces.push_back({face_buffer[0], face_buffer[i], face_buffer[i + 1]});
+        }
       }
     }
   } else if (line_label == "#") {
@@ -122,43 +391,41 @@ bool ObjParser::process_line(std::string&& line, Model& model) {
   return success;
 }
 
-std::optional<std::vector<glm::ivec3>> ObjParser::process_faces(const std::string_view& faces_string) {
-  std::vector<glm::ivec3> faces_result;
-  faces_result.reserve(3);
-  std::vector<std::string> faces = split_at_trim_separators(faces_string, ' ');
+bool ObjParser::process_faces(const std::string_view& faces_string, std::vector<glm::ivec3>& faces_result) {
+  faces_result.clear();
 
-  for (const auto& face : faces) {
-    std::vector<std::string> indices = split_at(face, '/');
+  for (const auto& face : SplitView{faces_string, ' ', true}) {
+    // 0 is not a valid obj face index, so we can indicate missing values with it
+    glm::ivec3 vertex_data(0);
+    glm::length_t indices_read = 0;
 
-    // There were more than 2 slashes for one vertex data
-    if (indices.size() > 3) {
-      return std::nullopt;
-    }
+    for (const auto& index : SplitView{face, '/'}) {
+      // There were more than 2 slashes for one vertex data
+      if (indices_read == vertex_data.length()) {
+        return false;
+      }
 
-    glm::ivec3 vertex_data(0);
+      if (!index.empty()) {
+        auto result = get_number_from_string<int>(index);
 
-    for (std::size_t i = 0; i < indices.size(); ++i) {
-      if (indices[i].empty()) {
-        // 0 is not a valid obj face index, so we can indicate missing values with it
-        vertex_data[i] = 0;
-      } else if (auto result = get_number_from_string<int>(indices[i]); result) {
-        vertex_data[i] = result->first;
-      } else {
-        return std::nullopt;
+        // The whole index has to be a number, "1a/2/3" is not a valid vertex either
+        if (!result || result->second != index.size()) {
+          return false;
+        }
+
+        vertex_data[indices_read] = result->first;
       }
-    }
 
-    faces_result.push_back(std::move(vertex_data));
-  }
+      ++indices_read;
+    }
 
-  if (!check_faces_vector_syntax(faces_result)) {
-    return std::nullopt;
+    faces_result.push_back(vertex_data);
   }
 
-  return faces_result;
+  return check_faces_vector_syntax(faces_result);
 }
 
-bool ObjParser::check_faces_vector_syntax(const std::vector<glm::ivec3> faces_vec) {
+bool ObjParser::check_faces_vector_syntax(const std::vector<glm::ivec3>& faces_vec) {
   // The syntax must be the same for all faces in the same line. So for example if there is no normal in the first
   // triplet, there mustn't be normals in the later triplets either
 
@@ -1,11 +1,14 @@
 #ifndef PARSER_OBJ_PARSER_HPP
 #define PARSER_OBJ_PARSER_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "../Types/Model.hpp"
 #include "ModelParser.hpp"
@@ -17,21 +20,90 @@ class ObjParser : public ModelParser {
  public:
   virtual ~ObjParser() {}
 
+  using ModelParser::parse;
+
+  // Faces are passed to sink right after their line is parsed. Streaming always parses on a single thread, because
+  // the faces have to arrive in order
+  virtual std::optional<Model> parse(const std::string& path, FaceSink& sink) override;
+  virtual bool is_streaming_serial() const override { return true; }
+
+  // Number of threads used to parse memory mapped files. 0 (the default) means one per hardware thread
+  // Files are only split if every thread gets at least min_chunk_size bytes, the result is the same either way
+  void set_num_threads(std::size_t num_threads);
+
+  // Quick pass over data that counts the v, vt and vn lines and the triangles the f lines will be split into, without
+  // parsing any numbers, so the model can be reserved exactly before the real parse
+  static ModelSize count_elements(std::string_view data);
+
+  // Push based parsing, for input that arrives in pieces. The pieces can be split anywhere, even in the middle of a
+  // line: complete lines are parsed as soon as they arrive, the unfinished last one is kept until the next call
+  // Returns false if a line couldn't be parsed. After that every feed fails until finish is called
+  bool feed(std::string_view bytes);
+
+  // Parses the last line (it doesn't need a terminating newline) and returns the model built from all the fed bytes
+  // The parser is ready to take a new input afterwards
+  std::optional<Model> finish();
+
  protected:
 #ifdef OBJ_PARSER_UNITTEST
   friend class ObjParserTest;
 #endif
-  // Reads input stream line-by-line and calls process_line on each line
+  // Reads input stream in blocks and feeds them to the parser
   virtual std::optional<Model> parse_file(std::istream& in) final override;
 
+  // Walks the lines of an in-memory file (eg. a memory mapped one) without copying them and calls process_line on each
+  // Large buffers are parsed in parallel with parse_chunks
+  virtual std::optional<Model> parse_buffer(std::string_view data) final override;
+
+  // Splits data into (at most) num_chunks pieces at line boundaries, parses them on separate threads and stitches the
+  // partial models together. The result is the same as parsing data in one go
+  std::optional<Model> parse_chunks(std::string_view data, std::size_t num_chunks);
+
+  // count_elements without the attributes that aren't required, they won't be stored
+  ModelSize count_required_elements(std::string_view data) const;
+
+  // Calls process_line on every line of data. On failure lines_processed is the (1-based) number of the bad line
+  bool process_lines(std::string_view data, Model& model, std::size_t& lines_processed);
+
   // Process a line. Update model, if it needs to based on the contents of the line
-  bool process_line(std::string&& line, Model& model);
+  bool process_line(std::string_view line, Model& model);
 
   // Processes the faces part of a line containing faces ("f 1 2 3" -> processes "1 2 3")
-  std::optional<std::vector<glm::ivec3>> process_faces(const std::string_view& faces_string);
+  // The vertices are written into faces_result, which is cleared first, so the same buffer can be reused for every line
+  bool process_faces(const std::string_view& faces_string, std::vector<glm::ivec3>& faces_result);
 
   // Checks if the result of process_faces is correct. It's only called by process_faces
-  bool check_faces_vector_syntax(const std::vector<glm::ivec3> faces_vec);
+  bool check_faces_vector_syntax(const std::vector<glm::ivec3>& faces_vec);
+
+ private:
+  // A corner of a triangular face with indices that were relative to the end of the attribute arrays ("f -3 -2 -1")
+  // When a chunk is parsed on its own, these indices only account for the attributes of the same chunk
+  struct RelativeCorner {
+    std::size_t face;
+    std::uint8_t corner;
+    // Bit 0: position index, bit 1: texture index, bit 2: normal index was relative
+    std::uint8_t components;
+  };
+
+  static constexpr std::size_t min_chunk_size = 4 * 1024 * 1024;
+
+  std::size_t num_threads = 0;
+
+  // Vertices of the face line being processed, kept between lines so faces don't allocate after the first few lines
+  std::vector<glm::ivec3> face_buffer;
+  // Relative components of the vertices in face_buffer, only filled when relative_corners is set
+  std::vector<std::uint8_t> relative_buffer;
+  // Set while parsing a chunk, collects the corners that have to be shifted when the chunks are stitched together
+  std::vector<RelativeCorner>* relative_corners = nullptr;
+  // Set while streaming, gets the faces instead of the model
+  FaceSink* face_sink = nullptr;
+
+  // State of push based parsing (feed/finish)
+  Model fed_model;
+  // The last line of the previous feed, if it didn't end with a newline
+  std::string partial_line;
+  std::size_t lines_fed = 0;
+  bool feed_failed      = false;
 };
 
 #endif
\ No newline at end of file
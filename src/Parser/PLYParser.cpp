@@ -0,0 +1,515 @@
+#include "PLYParser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "StringMethods.hpp"
+
+namespace {
+enum class ScalarType { int8, uint8, int16, uint16, int32, uint32, float32, float64 };
+
+struct Property {
+  std::string name;
+  ScalarType type;
+  // List properties start with their number of items, stored as count_type, followed by the items of type
+  bool is_list          = false;
+  ScalarType count_type = ScalarType::uint8;
+};
+
+struct Element {
+  std::string name;
+  std::size_t count = 0;
+  std::vector<Property> properties;
+};
+
+struct Header {
+  std::vector<Element> elements;
+  // The binary data starts right after the header
+  std::size_t size = 0;
+};
+
+std::optional<ScalarType> parse_scalar_type(std::string_view name) {
+  static const std::array<std::pair<std::string_view, ScalarType>, 16> types = {{
+      {"char", ScalarType::int8},
+      {"int8", ScalarType::int8},
+      {"uchar", ScalarType::uint8},
+      {"uint8", ScalarType::uint8},
+      {"short", ScalarType::int16},
+      {"int16", ScalarType::int16},
+      {"ushort", ScalarType::uint16},
+      {"uint16", ScalarType::uint16},
+      {"int", ScalarType::int32},
+      {"int32", ScalarType::int32},
+      {"uint", ScalarType::uint32},
+      {"uint32", ScalarType::uint32},
+      {"float", ScalarType::float32},
+      {"float32", ScalarType::float32},
+      {"double", ScalarType::float64},
+      {"float64", ScalarType::float64},
+  }};
+
+  for (const auto& [type_name, type] : types) {
+    if (type_name == name) {
+      return type;
+    }
+  }
+
+  return std::nullopt;
+}
+
+std::size_t scalar_size(ScalarType type) {
+  switch (type) {
+    case ScalarType::int8:
+    case ScalarType::uint8:
+      return 1;
+    case ScalarType::int16:
+    case ScalarType::uint16:
+      return 2;
+    case ScalarType::int32:
+    case ScalarType::uint32:
+    case ScalarType::float32:
+      return 4;
+    default:
+      return 8;
+  }
+}
+
+template <class Scalar>
+Scalar load(const char* data) {
+  Scalar value;
+  std::memcpy(&value, data, sizeof(Scalar));
+  return value;
+}
+
+// Binary PLY is read the same way as binary STL: the host has to be little-endian
+double read_scalar(ScalarType type, const char* data) {
+  switch (type) {
+    case ScalarType::int8:
+      return load<std::int8_t>(data);
+    case ScalarType::uint8:
+      return load<std::uint8_t>(data);
+    case ScalarType::int16:
+      return load<std::int16_t>(data);
+    case ScalarType::uint16:
+      return load<std::uint16_t>(data);
+    case ScalarType::int32:
+      return load<std::int32_t>(data);
+    case ScalarType::uint32:
+      return load<std::uint32_t>(data);
+    case ScalarType::float32:
+      return load<float>(data);
+    default:
+      return load<double>(data);
+  }
+}
+
+std::optional<Header> parse_header(std::string_view data) {
+  if (data.substr(0, 4) != "ply\n" && data.substr(0, 5) != "ply\r\n") {
+    std::cerr << "Not a PLY file\n";
+    return std::nullopt;
+  }
+
+  Header header;
+
+  // Line by line, only a whole line ends the header (end_header can be part of a comment too)
+  for (std::size_t line_start = 0;;) {
+    const std::size_t line_end = data.find('\n', line_start);
+    if (line_end == std::string_view::npos) {
+      std::cerr << "The header of the PLY file doesn't end\n";
+      return std::nullopt;
+    }
+
+    std::string_view line = data.substr(line_start, line_end - line_start);
+    line_start            = line_end + 1;
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+
+    if (line == "end_header") {
+      header.size = line_start;
+      return header;
+    }
+
+    const auto words = split_at_trim_separators(line, ' ');
+    if (words.empty() || words[0] == "ply" || words[0] == "comment" || words[0] == "obj_info") {
+      continue;
+    }
+
+    if (words[0] == "format") {
+      if (words.size() != 3 || words[1] != "binary_little_endian") {
+        std::cerr << "Only binary little-endian PLY files are supported\n";
+        return std::nullopt;
+      }
+    } else if (words[0] == "element" && words.size() == 3) {
+      const auto count = get_number_from_string<std::size_t>(words[2]);
+      if (!count || count->second != words[2].size()) {
+        std::cerr << "Invalid PLY element count: " << line << "\n";
+        return std::nullopt;
+      }
+      Element element;
+      element.name  = words[1];
+      element.count = count->first;
+      header.elements.push_back(std::move(element));
+    } else if (words[0] == "property" && !header.elements.empty()) {
+      Property property;
+      std::optional<ScalarType> type;
+
+      if (words.size() == 5 && words[1] == "list") {
+        const auto count_type = parse_scalar_type(words[2]);
+        type                  = parse_scalar_type(words[3]);
+        property.is_list      = true;
+        property.count_type   = count_type.value_or(ScalarType::float32);
+        property.name         = words[4];
+        // Counts must be integers
+        if (!count_type || *count_type == ScalarType::float32 || *count_type == ScalarType::float64) {
+          type.reset();
+        }
+      } else if (words.size() == 3) {
+        type          = parse_scalar_type(words[1]);
+        property.name = words[2];
+      }
+
+      if (!type) {
+        std::cerr << "Unsupported PLY property: " << line << "\n";
+        return std::nullopt;
+      }
+
+      property.type = *type;
+      header.elements.back().properties.push_back(std::move(property));
+    } else {
+      std::cerr << "Unsupported PLY header line: " << line << "\n";
+      return std::nullopt;
+    }
+  }
+}
+
+// Reads the records of an element one by one: position of each property of the current record, list or not
+class RecordReader {
+ public:
+  RecordReader(const Element& element, std::string_view data) : element{element}, data{data} {}
+
+  // Moves to the next record. Returns false if it doesn't fit into the data
+  bool next() {
+    offsets.clear();
+
+    for (const auto& property : element.properties) {
+      offsets.push_back(record_end);
+
+      std::size_t size = scalar_size(property.type);
+      if (property.is_list) {
+        if (record_end + scalar_size(property.count_type) > data.size()) {
+          return false;
+        }
+        size = scalar_size(property.count_type) + list_size(offsets.size() - 1) * size;
+      }
+
+      if (size > data.size() - record_end) {
+        return false;
+      }
+      record_end += size;
+    }
+
+    return true;
+  }
+
+  double scalar(std::size_t property) const {
+    return read_scalar(element.properties[property].type, data.data() + offsets[property]);
+  }
+
+  std::size_t list_size(std::size_t property) const {
+    const double size = read_scalar(element.properties[property].count_type, data.data() + offsets[property]);
+    return size > 0 ? static_cast<std::size_t>(size) : 0;
+  }
+
+  double list_item(std::size_t property, std::size_t item) const {
+    const Property& list = element.properties[property];
+    return read_scalar(list.type, data.data() + offsets[property] + scalar_size(list.count_type) +
+                                      item * scalar_size(list.type));
+  }
+
+  // End of the records read so far
+  std::size_t end() const { return record_end; }
+
+ private:
+  const Element& element;
+  std::string_view data;
+  std::vector<std::size_t> offsets;
+  std::size_t record_end = 0;
+};
+
+// Index of the property with one of the names, or -1
+int find_property(const Element& element, std::initializer_list<std::string_view> names) {
+  for (std::size_t i = 0; i < element.properties.size(); ++i) {
+    const Property& property = element.properties[i];
+    if (!property.is_list && std::find(names.begin(), names.end(), property.name) != names.end()) {
+      return static_cast<int>(i);
+    }
+  }
+
+  return -1;
+}
+
+bool is_float_xyz(const Element& element) {
+  return element.properties.size() == 3 && element.properties[0].name == "x" && element.properties[1].name == "y" &&
+         element.properties[2].name == "z" &&
+         std::all_of(element.properties.begin(), element.properties.end(), [](const Property& property) {
+           return !property.is_list && property.type == ScalarType::float32;
+         });
+}
+
+// Whether the records of the element can fit into data at all, with their smallest possible size (empty lists)
+// Checked before reserving memory for them, so a corrupt count can't allocate more than the data could hold. Records
+// without properties count as a byte, they are rejected anyway
+bool can_fit(const Element& element, std::string_view data) {
+  std::size_t record_size = 0;
+  for (const auto& property : element.properties) {
+    record_size += scalar_size(property.is_list ? property.count_type : property.type);
+  }
+
+  return element.count <= data.size() / std::max<std::size_t>(record_size, 1);
+}
+
+// Reads the vertex element at the start of data, returns the number of bytes it takes or nullopt if it doesn't fit
+std::optional<std::size_t> read_vertices(const Element& element,
+                                         std::string_view data,
+                                         const ModelAttributes& attributes,
+                                         Model& model) {
+  if (!can_fit(element, data)) {
+    return std::nullopt;
+  }
+
+  model.positions.reserve(element.count);
+
+  // The most common layout: nothing but the float coordinates, 12 bytes per vertex
+  if (is_float_xyz(element)) {
+    if (element.count > data.size() / (3 * sizeof(float))) {
+      return std::nullopt;
+    }
+
+    model.positions.resize(element.count);
+    for (std::size_t i = 0; i < element.count; ++i) {
+      std::memcpy(&model.positions[i].x, data.data() + i * 3 * sizeof(float), 3 * sizeof(float));
+      model.positions[i].w = 1.0f;
+    }
+
+    return element.count * 3 * sizeof(float);
+  }
+
+  const std::array<int, 3> position = {
+      find_property(element, {"x"}), find_property(element, {"y"}), find_property(element, {"z"})};
+  const std::array<int, 3> normal = {
+      find_property(element, {"nx"}), find_property(element, {"ny"}), find_property(element, {"nz"})};
+  const std::array<int, 2> texture = {find_property(element, {"u", "s", "texture_u", "texture_s"}),
+                                      find_property(element, {"v", "t", "texture_v", "texture_t"})};
+
+  if (std::count(position.begin(), position.end(), -1) > 0) {
+    std::cerr << "The PLY vertices have no x, y and z properties\n";
+    return std::nullopt;
+  }
+
+  const bool has_normals  = attributes.normals && std::count(normal.begin(), normal.end(), -1) == 0;
+  const bool has_textures = attributes.texture_coords && std::count(texture.begin(), texture.end(), -1) == 0;
+
+  RecordReader records{element, data};
+  for (std::size_t i = 0; i < element.count; ++i) {
+    if (!records.next()) {
+      return std::nullopt;
+    }
+
+    model.positions.push_back(
+        {records.scalar(position[0]), records.scalar(position[1]), records.scalar(position[2]), 1.0});
+    if (has_normals) {
+      model.normals.push_back({records.scalar(normal[0]), records.scalar(normal[1]), records.scalar(normal[2])});
+    }
+    if (has_textures) {
+      model.texture_coords.push_back({records.scalar(texture[0]), records.scalar(texture[1]), 0.0});
+    }
+  }
+
+  return records.end();
+}
+
+// Reads the face element at the start of data, returns the number of bytes it takes or nullopt if it doesn't fit or
+// refers to vertices that don't exist. The faces are passed to sink if it's set, otherwise they are added to model
+std::optional<std::size_t> read_faces(const Element& element, std::string_view data, Model& model, FaceSink* sink) {
+  int indices_property = -1;
+  for (std::size_t i = 0; i < element.properties.size(); ++i) {
+    const Property& property = element.properties[i];
+    if (property.is_list && (property.name == "vertex_indices" || property.name == "vertex_index")) {
+      indices_property = static_cast<int>(i);
+    }
+  }
+
+  if (indices_property == -1) {
+    std::cerr << "The PLY faces have no vertex_indices property\n";
+    return std::nullopt;
+  }
+
+  const std::size_t num_vertices = model.positions.size();
+  const bool has_textures        = !model.texture_coords.empty();
+  const bool has_normals         = !model.normals.empty();
+
+  // Every attribute of a vertex has the index of the vertex
+  const auto vertex = [&](std::int64_t index) {
+    const int i = static_cast<int>(index);
+    return glm::ivec3{i, has_textures ? i : -1, has_normals ? i : -1};
+  };
+
+  if (!can_fit(element, data)) {
+    return std::nullopt;
+  }
+
+  const auto add_face = [&](const std::array<glm::ivec3, 3>& face) {
+    if (sink) {
+      return sink->add_face(model, face);
+    }
+    model.triangular_faces.push_back(face);
+    return true;
+  };
+
+  if (!sink) {
+    model.triangular_faces.reserve(element.count);
+  }
+
+  const Property& indices = element.properties[indices_property];
+  // The most common layout: a uchar count and int indices, nothing else. Triangles are 13 bytes
+  if (element.properties.size() == 1 && indices.count_type == ScalarType::uint8 &&
+      (indices.type == ScalarType::int32 || indices.type == ScalarType::uint32)) {
+    std::size_t position = 0;
+
+    for (std::size_t face = 0; face < element.count; ++face) {
+      if (position >= data.size()) {
+        return std::nullopt;
+      }
+
+      const std::size_t count = static_cast<std::uint8_t>(data[position]);
+      if (count * sizeof(std::int32_t) > data.size() - position - 1) {
+        return std::nullopt;
+      }
+
+      std::array<std::int64_t, 256> polygon;
+      for (std::size_t i = 0; i < count; ++i) {
+        const char* item = data.data() + position + 1 + i * sizeof(std::int32_t);
+        polygon[i] = indices.type == ScalarType::int32 ? load<std::int32_t>(item) : load<std::uint32_t>(item);
+        if (polygon[i] < 0 || static_cast<std::size_t>(polygon[i]) >= num_vertices) {
+          std::cerr << "PLY face " << face << " refers to a vertex that doesn't exist\n";
+          return std::nullopt;
+        }
+      }
+
+      // Polygons are split into a triangle fan, like in OBJ files
+      for (std::size_t i = 1; i + 1 < count; ++i) {
+        if (!add_face({vertex(polygon[0]), vertex(polygon[i]), vertex(polygon[i + 1])})) {
+          return std::nullopt;
+        }
+      }
+
+      position += 1 + count * sizeof(std::int32_t);
+    }
+
+    return position;
+  }
+
+  RecordReader records{element, data};
+  std::vector<glm::ivec3> polygon;
+
+  for (std::size_t face = 0; face < element.count; ++face) {
+    if (!records.next()) {
+      return std::nullopt;
+    }
+
+    const std::size_t count = records.list_size(indices_property);
+    polygon.clear();
+
+    for (std::size_t i = 0; i < count; ++i) {
+      const double index = records.list_item(indices_property, i);
+      if (index < 0 || index >= num_vertices) {
+        std::cerr << "PLY face " << face << " refers to a vertex that doesn't exist\n";
+        return std::nullopt;
+      }
+      polygon.push_back(vertex(static_cast<std::int64_t>(index)));
+    }
+
+    for (std::size_t i = 1; i + 1 < count; ++i) {
+      if (!add_face({polygon[0], polygon[i], polygon[i + 1]})) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  return records.end();
+}
+
+// Skips an element that isn't used, returns the number of bytes it takes or nullopt if it doesn't fit
+std::optional<std::size_t> skip_element(const Element& element, std::string_view data) {
+  RecordReader records{element, data};
+  for (std::size_t i = 0; i < element.count; ++i) {
+    if (!records.next()) {
+      return std::nullopt;
+    }
+  }
+
+  return records.end();
+}
+}  // namespace
+
+std::optional<Model> PLYParser::parse(const std::string& path, FaceSink& sink) {
+  // A cached model already has all its faces, there is nothing left to stream
+  if (is_cache_enabled()) {
+    return ModelParser::parse(path, sink);
+  }
+
+  face_sink   = &sink;
+  auto result = ModelParser::parse(path);
+  face_sink   = nullptr;
+
+  return result;
+}
+
+std::optional<Model> PLYParser::parse_file(std::istream& in) {
+  const std::string data{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+  return parse_buffer(data);
+}
+
+std::optional<Model> PLYParser::parse_buffer(std::string_view data) {
+  const auto header = parse_header(data);
+  if (!header) {
+    return std::nullopt;
+  }
+
+  data.remove_prefix(header->size);
+
+  Model model{0};
+  bool has_vertices = false;
+
+  for (const Element& element : header->elements) {
+    std::optional<std::size_t> element_size;
+
+    if (element.name == "vertex") {
+      element_size = read_vertices(element, data, get_required_attributes(), model);
+      has_vertices = true;
+    } else if (element.name == "face" && has_vertices) {
+      element_size = read_faces(element, data, model, face_sink);
+    } else if (element.name == "face") {
+      std::cerr << "The PLY faces come before the vertices\n";
+      return std::nullopt;
+    } else {
+      element_size = skip_element(element, data);
+    }
+
+    if (!element_size) {
+      std::cerr << "Failed to read the " << element.name << " element of the PLY file\n";
+      return std::nullopt;
+    }
+
+    data.remove_prefix(*element_size);
+  }
+
+  return model;
+}
@@ -0,0 +1,37 @@
+#ifndef PARSER_PLY_PARSER_HPP
+#define PARSER_PLY_PARSER_HPP
+
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "../Types/Model.hpp"
+#include "ModelParser.hpp"
+
+// Reads binary little-endian PLY files. The vertex element gives the positions (x, y, z) and, if present, the normals
+// (nx, ny, nz) and texture coordinates (u, v or s, t) of the vertices. The face element has a list of vertex indices,
+// polygons are split into triangles. Any other element or property is skipped
+// Files are memory mapped by ModelParser::parse, and vertices and faces in the common layouts (float x y z, faces with
+// a uchar count and int indices) are copied in bulk
+class PLYParser : public ModelParser {
+ public:
+  using ModelParser::parse;
+
+  // Faces are passed to sink as they are read, the vertices come before them
+  virtual std::optional<Model> parse(const std::string& path, FaceSink& sink) override final;
+
+  virtual ~PLYParser() {}
+
+ protected:
+  // Reads the whole stream into memory and parses it with parse_buffer, binary PLY can't be parsed line by line
+  virtual std::optional<Model> parse_file(std::istream& in) override final;
+
+  virtual std::optional<Model> parse_buffer(std::string_view data) override final;
+
+ private:
+  // Set while streaming, gets the faces instead of the model
+  FaceSink* face_sink = nullptr;
+};
+
+#endif
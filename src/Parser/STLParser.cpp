@@ -0,0 +1,238 @@
+#include "STLParser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../Parallel/Parallel.hpp"
+
+namespace {
+const std::size_t header_size = 84;
+// Normal, 3 corners and the attribute byte count
+const std::size_t record_size = 50;
+// Corners handled by one parallel task, a multiple of 3 so every task has whole triangles
+const std::size_t corners_per_task = 3 << 14;
+
+// The 48 bytes of the normal and the corners of a record, read at once
+struct Record {
+  std::array<float, 3> normal;
+  std::array<std::array<float, 3>, 3> corners;
+};
+static_assert(sizeof(Record) == 48, "Records must be read without padding");
+
+// Bit patterns of the coordinates of a corner, which are compared and hashed. -0 is turned into 0
+struct CornerKey {
+  std::array<std::uint32_t, 3> bits;
+
+  bool operator==(const CornerKey& other) const { return bits == other.bits; }
+};
+
+// Reads the records of an STL file in memory and finds the corners in the hash table
+class STLCorners {
+ public:
+  explicit STLCorners(std::string_view data) : records{data.data() + header_size} {}
+
+  Record record(std::size_t triangle) const {
+    Record result;
+    std::memcpy(&result, records + triangle * record_size, sizeof(Record));
+    return result;
+  }
+
+  CornerKey key(std::size_t corner) const {
+    CornerKey key;
+    std::memcpy(key.bits.data(), records + corner / 3 * record_size + 12 + corner % 3 * 12, 12);
+
+    for (auto& bits : key.bits) {
+      if (bits == 0x80000000u) {
+        bits = 0;
+      }
+    }
+
+    return key;
+  }
+
+ private:
+  const char* records;
+};
+
+std::uint64_t hash_key(const CornerKey& key) {
+  std::uint64_t hash = (static_cast<std::uint64_t>(key.bits[0]) << 32 | key.bits[1]) * 0x9e3779b97f4a7c15ULL;
+  hash ^= (hash >> 29) ^ key.bits[2];
+  hash *= 0xbf58476d1ce4e5b9ULL;
+
+  return hash ^ (hash >> 32);
+}
+
+// Open addressing hash table of the corners with linear probing. Every slot holds the smallest index + 1 of the corners
+// with its key, or 0 if it's empty. Inserting keeps the smallest index with atomic compare and swaps, so the table
+// ends up the same no matter which thread inserts first
+class CornerTable {
+ public:
+  CornerTable(const STLCorners& corners, std::size_t num_corners) : corners{corners} {
+    std::size_t size = 1;
+    while (size < 2 * num_corners) {
+      size *= 2;
+    }
+
+    // Value-initialized, so every slot starts empty
+    slots = std::vector<std::atomic<std::uint32_t>>(size);
+    mask  = size - 1;
+  }
+
+  void insert(std::uint32_t corner) {
+    const CornerKey key = corners.key(corner);
+
+    for (std::size_t slot = hash_key(key) & mask;; slot = (slot + 1) & mask) {
+      std::uint32_t current = slots[slot].load(std::memory_order_relaxed);
+
+      if (current == 0 && slots[slot].compare_exchange_strong(current, corner + 1, std::memory_order_relaxed)) {
+        return;
+      }
+      // Lost the race for an empty slot, current is the winner now
+      if (!(corners.key(current - 1) == key)) {
+        continue;
+      }
+
+      while (current > corner + 1 &&
+             !slots[slot].compare_exchange_weak(current, corner + 1, std::memory_order_relaxed)) {
+      }
+      return;
+    }
+  }
+
+  // The first corner with the same coordinates as corner. Only valid after all corners were inserted
+  std::uint32_t first_occurrence(std::uint32_t corner) const {
+    const CornerKey key = corners.key(corner);
+
+    for (std::size_t slot = hash_key(key) & mask;; slot = (slot + 1) & mask) {
+      const std::uint32_t current = slots[slot].load(std::memory_order_relaxed);
+      if (corners.key(current - 1) == key) {
+        return current - 1;
+      }
+    }
+  }
+
+ private:
+  const STLCorners& corners;
+  std::vector<std::atomic<std::uint32_t>> slots;
+  std::size_t mask = 0;
+};
+}  // namespace
+
+void STLParser::set_num_threads(std::size_t num_threads) { this->num_threads = num_threads; }
+
+std::optional<Model> STLParser::parse_file(std::istream& in) {
+  const std::string data{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+  return parse_buffer(data);
+}
+
+std::optional<Model> STLParser::parse_buffer(std::string_view data) {
+  if (data.size() < header_size) {
+    std::cerr << "The STL file is too short for a header\n";
+    return std::nullopt;
+  }
+
+  std::uint32_t num_triangles = 0;
+  std::memcpy(&num_triangles, data.data() + header_size - sizeof(std::uint32_t), sizeof(std::uint32_t));
+
+  if ((data.size() - header_size) / record_size < num_triangles) {
+    // ASCII STL starts with "solid", and the "triangle count" is some text
+    if (data.substr(0, 5) == "solid") {
+      std::cerr << "Only binary STL files are supported\n";
+    } else {
+      std::cerr << "The STL file is shorter than its " << num_triangles << " triangles\n";
+    }
+    return std::nullopt;
+  }
+
+  const std::size_t num_corners = 3 * static_cast<std::size_t>(num_triangles);
+  if (num_corners >= static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+    std::cerr << "The STL file has too many triangles\n";
+    return std::nullopt;
+  }
+
+  const STLCorners corners{data};
+  CornerTable table{corners, num_corners};
+
+  const std::size_t num_tasks = (num_corners + corners_per_task - 1) / corners_per_task;
+  const auto for_each_task    = [&](auto&& function) {
+    parallel_for(num_tasks, num_threads, [&](std::size_t task) {
+      const std::size_t first = task * corners_per_task;
+      function(task, first, std::min(first + corners_per_task, num_corners));
+    });
+  };
+
+  for_each_task([&](std::size_t, std::size_t first, std::size_t last) {
+    for (std::size_t corner = first; corner < last; ++corner) {
+      table.insert(corner);
+    }
+  });
+
+  // The first occurrence of every corner, and how many new positions every task has
+  std::vector<std::uint32_t> first_occurrences(num_corners);
+  std::vector<std::size_t> task_positions(num_tasks + 1, 0);
+
+  for_each_task([&](std::size_t task, std::size_t first, std::size_t last) {
+    for (std::size_t corner = first; corner < last; ++corner) {
+      first_occurrences[corner] = table.first_occurrence(corner);
+      task_positions[task + 1] += first_occurrences[corner] == corner;
+    }
+  });
+
+  // Positions are numbered in the order of their first occurrence
+  for (std::size_t task = 0; task < num_tasks; ++task) {
+    task_positions[task + 1] += task_positions[task];
+  }
+
+  const bool read_normals = get_required_attributes().normals;
+
+  Model model{0};
+  model.positions.resize(task_positions.back());
+  model.triangular_faces.resize(num_triangles);
+  if (read_normals) {
+    model.normals.resize(num_triangles);
+  }
+
+  // New positions first, so every corner can look up the index of its first occurrence afterwards
+  std::vector<std::uint32_t> position_indices(num_corners);
+
+  for_each_task([&](std::size_t task, std::size_t first, std::size_t last) {
+    std::size_t next_position = task_positions[task];
+
+    for (std::size_t corner = first; corner < last; ++corner) {
+      if (first_occurrences[corner] == corner) {
+        const CornerKey key = corners.key(corner);
+        glm::vec4& position = model.positions[next_position];
+        std::memcpy(&position.x, key.bits.data(), 3 * sizeof(float));
+        position.w = 1.0f;
+
+        position_indices[corner] = next_position++;
+      }
+    }
+  });
+
+  for_each_task([&](std::size_t, std::size_t first, std::size_t last) {
+    for (std::size_t triangle = first / 3; triangle < last / 3; ++triangle) {
+      const int normal = read_normals ? static_cast<int>(triangle) : -1;
+
+      if (read_normals) {
+        const Record record     = corners.record(triangle);
+        model.normals[triangle] = glm::vec3{record.normal[0], record.normal[1], record.normal[2]};
+      }
+
+      for (std::size_t corner = 0; corner < 3; ++corner) {
+        const int position = position_indices[first_occurrences[3 * triangle + corner]];
+        model.triangular_faces[triangle][corner] = glm::ivec3{position, -1, normal};
+      }
+    }
+  });
+
+  return model;
+}
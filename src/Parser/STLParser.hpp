@@ -0,0 +1,35 @@
+#ifndef PARSER_STL_PARSER_HPP
+#define PARSER_STL_PARSER_HPP
+
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <string_view>
+
+#include "../Types/Model.hpp"
+#include "ModelParser.hpp"
+
+// Reads binary STL files. STL stores every corner of every triangle separately, the corners with identical coordinates
+// are welded into one position, so the result is an indexed mesh. Positions are numbered in the order of their first
+// occurrence, so the result doesn't depend on the number of threads. 0 and -0 are the same coordinate
+// The facet normal of every triangle is stored as its own normal, referenced by the 3 corners
+class STLParser : public ModelParser {
+ public:
+  using ModelParser::parse;
+
+  // Number of threads decoding and welding the triangles (0 means all hardware threads)
+  void set_num_threads(std::size_t num_threads);
+
+  virtual ~STLParser() {}
+
+ protected:
+  // Reads the whole stream into memory and parses it with parse_buffer
+  virtual std::optional<Model> parse_file(std::istream& in) override final;
+
+  virtual std::optional<Model> parse_buffer(std::string_view data) override final;
+
+ private:
+  std::size_t num_threads = 0;
+};
+
+#endif
@@ -2,123 +2,219 @@
 #define PARSER_STRING_METHODS_HPP
 
 #include <algorithm>
-#include <iostream>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "StructuralScanner.hpp"
+
+// Range over the parts of text between separators. The parts are views into text, so nothing is copied or allocated
+// Separators are searched with the StructuralScanner, 16-32 characters at a time
+// With trim_separators set, duplicated separators and separators at the end/start of text are skipped, so no empty
+// parts are produced (same as split_at_trim_separators), otherwise it splits the same way as split_at
+class SplitView {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::string_view;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const std::string_view*;
+    using reference         = const std::string_view&;
+
+    iterator() = default;
+
+    reference operator*() const { return token; }
+    pointer operator->() const { return &token; }
+
+    iterator& operator++();
+    iterator operator++(int);
+
+    bool operator==(const iterator& other) const { return position == other.position; }
+    bool operator!=(const iterator& other) const { return position != other.position; }
+
+   private:
+    friend class SplitView;
+
+    iterator(const SplitView* view, std::size_t position);
+
+    // Sets token to the part starting at position, or makes this the end iterator if there are no more parts
+    void find_token(std::size_t from);
+
+    const SplitView* view = nullptr;
+    std::size_t position  = std::string_view::npos;
+    std::string_view token;
+  };
+
+  SplitView(const std::string_view& text, const char separator, const bool trim_separators = false)
+      : text{text}, separator{separator}, trim_separators{trim_separators} {}
+
+  iterator begin() const { return iterator{this, 0}; }
+  iterator end() const { return iterator{}; }
+
+ private:
+  std::string_view text;
+  char separator;
+  bool trim_separators;
+};
+
 // Splits text at separator
 inline std::vector<std::string> split_at(const std::string_view& text, const char separator);
 // Split text at separator, but duplicated separators and separators at the end/start of text are removed
 inline std::vector<std::string> split_at_trim_separators(const std::string_view& text, const char separator);
 
 // Tries to read a number from text and returns an optional (value, characters_processed) pair
+// Leading whitespaces and a leading '+' are accepted, like std::stod does. Parsing doesn't depend on the locale,
+// doesn't allocate or throw, and floating point results are correctly rounded to Result
 template <class Result>
-std::optional<std::pair<Result, std::size_t>> get_number_from_string(const std::string& text);
+std::optional<std::pair<Result, std::size_t>> get_number_from_string(const std::string_view& text) noexcept;
 
 // Tries to read at least min, at most max numbers from text into container
 // Returns the number of arguments successfully read
 // Whitespaces are discarded at the beginning of each number, but any extra characters at the end
 // will cause this function to fail
 template <class Container>
-std::optional<std::size_t> read_numbers(const std::string& text,
+std::optional<std::size_t> read_numbers(const std::string_view& text,
                                         std::size_t text_position,
                                         Container& container,
                                         const std::size_t min,
                                         const std::size_t max);
 
 
-inline std::vector<std::string> split_at(const std::string_view& text, const char separator) {
-  std::vector<std::string> tokens;
+inline SplitView::iterator::iterator(const SplitView* view, std::size_t position) : view{view}, position{position} {
+  if (view->text.empty()) {
+    this->position = std::string_view::npos;
+  } else {
+    find_token(position);
+  }
+}
 
-  for (auto from = text.cbegin(), to = from; to != text.cend();) {
-    to = std::find(from, text.cend(), separator);
-    tokens.push_back(std::string{from, to});
+inline void SplitView::iterator::find_token(std::size_t from) {
+  const std::string_view& text     = view->text;
+  const StructuralScanner& scanner = StructuralScanner::best();
+  const char* const text_end       = text.data() + text.size();
 
-    from = to;
+  if (view->trim_separators) {
+    from = scanner.find_not(text.data() + from, text_end, view->separator) - text.data();
 
-    if (from != text.cend()) {
-      ++from;
+    if (from == text.size()) {
+      position = std::string_view::npos;
+      return;
     }
   }
 
-  return tokens;
+  const std::size_t to = scanner.find(text.data() + from, text_end, view->separator) - text.data();
+
+  position = from;
+  token    = text.substr(from, to - from);
+}
+
+inline SplitView::iterator& SplitView::iterator::operator++() {
+  const std::size_t token_end = position + token.size();
+
+  // Without trimming, a separator at the very end still produces a last, empty part, which ends at text.size()
+  if (token_end == view->text.size()) {
+    position = std::string_view::npos;
+  } else {
+    find_token(token_end + 1);
+  }
+
+  return *this;
+}
+
+inline SplitView::iterator SplitView::iterator::operator++(int) {
+  iterator previous = *this;
+  ++*this;
+  return previous;
 }
 
-std::vector<std::string> split_at_trim_separators(const std::string_view& text, const char separator) {
+inline std::vector<std::string> split_at(const std::string_view& text, const char separator) {
   std::vector<std::string> tokens;
 
-  auto from = std::find_if(
-      text.cbegin(), text.cend(), [separator](std::string::const_iterator::value_type ch) { return ch != separator; });
-  auto to = from;
+  for (const auto& token : SplitView{text, separator}) {
+    tokens.emplace_back(token);
+  }
 
-  while (to != text.cend()) {
-    to = std::find(from, text.cend(), separator);
-    tokens.push_back(std::string{from, to});
+  return tokens;
+}
 
-    // If there are multiple separators next to each other, remove them
-    if (to != text.cend()) {
-      ++to;
-      from = std::find_if(
-          to, text.cend(), [separator](std::string::const_iterator::value_type ch) { return ch != separator; });
-      to = from;
-    }
+inline std::vector<std::string> split_at_trim_separators(const std::string_view& text, const char separator) {
+  std::vector<std::string> tokens;
+
+  for (const auto& token : SplitView{text, separator, true}) {
+    tokens.emplace_back(token);
   }
 
   return tokens;
 }
 
 template <class Result>
-std::optional<std::pair<Result, std::size_t>> get_number_from_string(const std::string& text) {
-  std::size_t chars_processed = 0;
-  Result result               = 0;
-
-  try {
-    if constexpr (std::is_floating_point_v<Result>) {
-      result = std::stod(text, &chars_processed);
-    } else if (std::is_integral_v<Result>) {
-      result = std::stoi(text, &chars_processed);
-    } else {
-      std::cerr << "Please give a number as template parameter of \"get_number_from_string\"\n";
-    }
-  } catch (const std::exception& ex) {
-    return std::nullopt;
+std::optional<std::pair<Result, std::size_t>> get_number_from_string(const std::string_view& text) noexcept {
+  static_assert(std::is_arithmetic_v<Result>, "Please give a number as template parameter of get_number_from_string");
+
+  const char* const text_begin = text.data();
+  const char* const text_end   = text_begin + text.size();
+
+  // The same characters std::isspace accepts in the "C" locale
+  const char* number_begin = std::find_if(text_begin, text_end, [](char ch) {
+    return ch != ' ' && ch != '\t' && ch != '\n' && ch != '\v' && ch != '\f' && ch != '\r';
+  });
+
+  // from_chars only accepts a minus sign, but "+1.0" is a valid number in an obj file
+  if (number_begin != text_end && *number_begin == '+' && number_begin + 1 != text_end && number_begin[1] != '-') {
+    ++number_begin;
   }
 
-  // from_chars is not yet available for floating points with g++ 8.3
-  // auto [first_not_matching, parse_result] = std::from_chars(text.data(), text.data() + text.size(), result);
+  Result result            = 0;
+  auto [number_end, error] = std::from_chars(number_begin, text_end, result);
+
+  // Values out of the range of a float, like 1e-50 or 1e39, are read as double and narrowed to 0 or infinity, the same
+  // way std::stod and a cast did before
+  if constexpr (std::is_floating_point_v<Result> && sizeof(Result) < sizeof(double)) {
+    if (error == std::errc::result_out_of_range) {
+      double wide                       = 0;
+      const auto [wide_end, wide_error] = std::from_chars(number_begin, text_end, wide);
+      result                            = static_cast<Result>(wide);
+      number_end                        = wide_end;
+      error                             = wide_error;
+    }
+  }
 
-  // if(parse_result == std::errc()) {
-  //   return std::nullopt;
-  // }
+  if (error != std::errc{}) {
+    return std::nullopt;
+  }
 
-  return std::make_pair(result, chars_processed);
+  return std::make_pair(result, static_cast<std::size_t>(number_end - text_begin));
 }
 
 template <class Container>
-std::optional<std::size_t> read_numbers(const std::string& text,
+std::optional<std::size_t> read_numbers(const std::string_view& text,
                                         std::size_t text_position,
                                         Container& container,
                                         const std::size_t min,
                                         const std::size_t max) {
+  // Parse straight into the element type, so floats are rounded once, not first to double and then to float
+  using Number = std::remove_cv_t<std::remove_reference_t<decltype(container[0])>>;
+
   std::size_t numbers_read         = 0;
   std::size_t part_to_process_next = text_position;
 
   // Read the first 3 coordinates
   while (numbers_read < max && part_to_process_next < text.size()) {
-    if (part_to_process_next < text.size()) {
-      auto result = get_number_from_string<double>(std::string{text, part_to_process_next});
-      if (result) {
-        container[numbers_read] = result->first;
-        part_to_process_next += result->second;
-        ++numbers_read;
-      } else {
-        // Something went wrong while reading numbers
-        return std::nullopt;
-      }
+    auto result = get_number_from_string<Number>(text.substr(part_to_process_next));
+    if (result) {
+      container[numbers_read] = result->first;
+      part_to_process_next += result->second;
+      ++numbers_read;
     } else {
-      // We reached the end before we should have, there was an error
+      // Something went wrong while reading numbers
       return std::nullopt;
     }
   }
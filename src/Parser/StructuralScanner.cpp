@@ -0,0 +1,187 @@
+#include "StructuralScanner.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+const char* scalar_find(const char* first, const char* last, char ch) { return std::find(first, last, ch); }
+
+const char* scalar_find_not(const char* first, const char* last, char ch) {
+  return std::find_if(first, last, [ch](char current) { return current != ch; });
+}
+
+std::uint64_t scalar_match_64(const char* block, char ch) {
+  std::uint64_t mask = 0;
+  for (int i = 0; i < 64; ++i) {
+    mask |= static_cast<std::uint64_t>(block[i] == ch) << i;
+  }
+
+  return mask;
+}
+
+#ifdef SIMD_X86
+int count_trailing_zeros(std::uint32_t mask) { return __builtin_ctz(mask); }
+
+inline __attribute__((always_inline)) std::uint32_t sse2_match_16(const char* block, __m128i pattern) {
+  const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, pattern)));
+}
+
+const char* sse2_find(const char* first, const char* last, char ch) {
+  const __m128i pattern = _mm_set1_epi8(ch);
+
+  for (; last - first >= 16; first += 16) {
+    if (const std::uint32_t mask = sse2_match_16(first, pattern); mask != 0) {
+      return first + count_trailing_zeros(mask);
+    }
+  }
+
+  return scalar_find(first, last, ch);
+}
+
+const char* sse2_find_not(const char* first, const char* last, char ch) {
+  const __m128i pattern = _mm_set1_epi8(ch);
+
+  for (; last - first >= 16; first += 16) {
+    if (const std::uint32_t mask = sse2_match_16(first, pattern) ^ 0xFFFF; mask != 0) {
+      return first + count_trailing_zeros(mask);
+    }
+  }
+
+  return scalar_find_not(first, last, ch);
+}
+
+std::uint64_t sse2_match_64(const char* block, char ch) {
+  const __m128i pattern = _mm_set1_epi8(ch);
+
+  return static_cast<std::uint64_t>(sse2_match_16(block, pattern)) |
+         static_cast<std::uint64_t>(sse2_match_16(block + 16, pattern)) << 16 |
+         static_cast<std::uint64_t>(sse2_match_16(block + 32, pattern)) << 32 |
+         static_cast<std::uint64_t>(sse2_match_16(block + 48, pattern)) << 48;
+}
+
+__attribute__((target("avx2"))) std::uint32_t avx2_match_32(const char* block, __m256i pattern) {
+  const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+  return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, pattern)));
+}
+
+// The tails are handled here as well instead of calling the SSE2 versions: mixing legacy SSE and AVX code has a big
+// transition penalty on some CPUs, and most tokens are short, so the tail is the common case
+__attribute__((target("avx2"))) const char* avx2_find(const char* first, const char* last, char ch) {
+  const __m256i pattern = _mm256_set1_epi8(ch);
+
+  for (; last - first >= 32; first += 32) {
+    if (const std::uint32_t mask = avx2_match_32(first, pattern); mask != 0) {
+      return first + count_trailing_zeros(mask);
+    }
+  }
+
+  if (last - first >= 16) {
+    if (const std::uint32_t mask = sse2_match_16(first, _mm256_castsi256_si128(pattern)); mask != 0) {
+      return first + count_trailing_zeros(mask);
+    }
+    first += 16;
+  }
+
+  while (first != last && *first != ch) ++first;
+
+  return first;
+}
+
+__attribute__((target("avx2"))) const char* avx2_find_not(const char* first, const char* last, char ch) {
+  const __m256i pattern = _mm256_set1_epi8(ch);
+
+  for (; last - first >= 32; first += 32) {
+    if (const std::uint32_t mask = ~avx2_match_32(first, pattern); mask != 0) {
+      return first + count_trailing_zeros(mask);
+    }
+  }
+
+  if (last - first >= 16) {
+    if (const std::uint32_t mask = sse2_match_16(first, _mm256_castsi256_si128(pattern)) ^ 0xFFFF; mask != 0) {
+      return first + count_trailing_zeros(mask);
+    }
+    first += 16;
+  }
+
+  while (first != last && *first == ch) ++first;
+
+  return first;
+}
+
+__attribute__((target("avx2"))) std::uint64_t avx2_match_64(const char* block, char ch) {
+  const __m256i pattern = _mm256_set1_epi8(ch);
+
+  return static_cast<std::uint64_t>(avx2_match_32(block, pattern)) |
+         static_cast<std::uint64_t>(avx2_match_32(block + 32, pattern)) << 32;
+}
+#endif
+}  // namespace
+
+const StructuralScanner& StructuralScanner::best() {
+  static const StructuralScanner scanner{Level::avx2};
+  return scanner;
+}
+
+StructuralScanner::StructuralScanner(Level level) {
+  this->level = supported_simd_level(level);
+
+  switch (this->level) {
+#ifdef SIMD_X86
+    case Level::avx2:
+      find_impl     = avx2_find;
+      find_not_impl = avx2_find_not;
+      match_64_impl = avx2_match_64;
+      break;
+    case Level::sse2:
+      find_impl     = sse2_find;
+      find_not_impl = sse2_find_not;
+      match_64_impl = sse2_match_64;
+      break;
+#endif
+    default:
+      find_impl     = scalar_find;
+      find_not_impl = scalar_find_not;
+      match_64_impl = scalar_match_64;
+      break;
+  }
+}
+
+bool LineScanner::next(std::string_view& line) {
+  if (line_start >= text.size()) {
+    return false;
+  }
+
+  while (newline_mask == 0) {
+    // No newline after line_start: the rest of the text is the last line
+    if (next_block >= text.size()) {
+      line       = text.substr(line_start);
+      line_start = text.size();
+      return true;
+    }
+
+    block_start = next_block;
+    next_block += 64;
+
+    if (next_block <= text.size()) {
+      newline_mask = scanner.match_64(text.data() + block_start, '\n');
+    } else {
+      // The last, partial block is copied into a padded buffer, so the scanner never reads past the end of text
+      char tail[64] = {};
+      std::memcpy(tail, text.data() + block_start, text.size() - block_start);
+      newline_mask = scanner.match_64(tail, '\n') & ((std::uint64_t{1} << (text.size() - block_start)) - 1);
+    }
+  }
+
+  const std::size_t line_end = block_start + __builtin_ctzll(newline_mask);
+  newline_mask &= newline_mask - 1;
+
+  line       = text.substr(line_start, line_end - line_start);
+  line_start = line_end + 1;
+
+  return true;
+}
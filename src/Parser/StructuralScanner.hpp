@@ -0,0 +1,66 @@
+#ifndef PARSER_STRUCTURAL_SCANNER_HPP
+#define PARSER_STRUCTURAL_SCANNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "../Parallel/SimdLevel.hpp"
+
+// Finds the structural characters of text formats (newlines, spaces, slashes) 16 or 32 bytes at a time
+// The implementation is picked at runtime based on the instruction sets of the CPU, with a plain scalar fallback
+class StructuralScanner {
+ public:
+  using Level = SimdLevel;
+
+  // Scanner using the widest instructions the CPU supports. Detected once, on the first call
+  static const StructuralScanner& best();
+
+  // Uses the given level, or the best supported one below it, if the CPU can't run it
+  explicit StructuralScanner(Level level);
+
+  Level get_level() const { return level; }
+
+  // First character equal to ch in [first, last), or last if there is none
+  const char* find(const char* first, const char* last, char ch) const { return find_impl(first, last, ch); }
+
+  // First character not equal to ch in [first, last), or last if there is none
+  const char* find_not(const char* first, const char* last, char ch) const { return find_not_impl(first, last, ch); }
+
+  // Bit i is set if block[i] == ch. block must have at least 64 readable bytes
+  std::uint64_t match_64(const char* block, char ch) const { return match_64_impl(block, ch); }
+
+ private:
+  Level level;
+  const char* (*find_impl)(const char*, const char*, char);
+  const char* (*find_not_impl)(const char*, const char*, char);
+  std::uint64_t (*match_64_impl)(const char*, char);
+};
+
+// Splits text into lines with the newline bitmasks of a StructuralScanner, 64 bytes at a time
+// Same semantics as std::getline: the last line doesn't need a terminating newline, and a newline at the very end
+// doesn't produce an extra empty line. The lines are views into text, without the newline
+class LineScanner {
+ public:
+  explicit LineScanner(std::string_view text, const StructuralScanner& scanner = StructuralScanner::best())
+      : text{text}, scanner{scanner} {}
+
+  // Sets line to the next line and returns true, or returns false if there are no lines left
+  bool next(std::string_view& line);
+
+  // Offset of the first character that wasn't returned in a line yet
+  std::size_t position() const { return line_start; }
+
+ private:
+  std::string_view text;
+  const StructuralScanner& scanner;
+
+  std::size_t line_start = 0;
+  // Start of the block the newline mask belongs to, and the start of the next block to scan
+  std::size_t block_start = 0;
+  std::size_t next_block  = 0;
+  // Newlines in the current block that haven't been returned yet
+  std::uint64_t newline_mask = 0;
+};
+
+#endif
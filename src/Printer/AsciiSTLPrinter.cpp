@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <array>
+#include <variant>
+#include <vector>
+
+#include "../Computations/FaceNormals.hpp"
+#include "../Types/Model.hpp"
+#include "AsciiSTLPrinter.hpp"
+#include "TextBuffer.hpp"
+
+namespace {
+// Triangles formatted by one task, about a megabyte of text
+const std::size_t triangles_per_chunk = 4096;
+
+// Only x, y and z are written. If homogenous coordinate support is desired, we could divide them by w
+template <class Vector>
+void append_vector(TextBuffer& buffer, const Vector& vec) {
+  buffer.append(vec.x);
+  buffer.append(' ');
+  buffer.append(vec.y);
+  buffer.append(' ');
+  buffer.append(vec.z);
+  buffer.append('\n');
+}
+
+void append_triangle(TextBuffer& buffer,
+                     const glm::vec3& normal,
+                     const Model& model,
+                     const std::array<glm::ivec3, 3>& face) {
+  buffer.append("facet normal ");
+  append_vector(buffer, normal);
+  buffer.append("outer loop\n");
+  for (const auto& vertex : face) {
+    buffer.append("vertex ");
+    append_vector(buffer, model.positions[vertex.x]);
+  }
+  buffer.append("endloop\nendfacet\n");
+}
+}  // namespace
+
+void AsciiSTLPrinter::set_recompute_normals(bool recompute_normals) { this->recompute_normals = recompute_normals; }
+
+void AsciiSTLPrinter::set_num_threads(std::size_t num_threads) { this->num_threads = num_threads; }
+
+bool AsciiSTLPrinter::print(const Model& model, const std::string& path) {
+  return print_faces(
+      model,
+      model.triangular_faces.size(),
+      [&](std::size_t i) -> const auto& { return model.triangular_faces[i]; },
+      path);
+}
+
+bool AsciiSTLPrinter::print_compact(const Model& model, const CompactFaces& faces, const std::string& path) {
+  return std::visit(
+      [&](const auto& alternative) {
+        return print_faces(
+            model, alternative.positions.size(), [&](std::size_t i) { return expand_face(alternative, i); }, path);
+      },
+      faces);
+}
+
+template <class Faces>
+bool AsciiSTLPrinter::print_faces(const Model& model,
+                                  std::size_t num_faces,
+                                  const Faces& face,
+                                  const std::string& path) {
+  auto open_result = open_writer(path);
+  if (!open_result) {
+    return false;
+  }
+
+  FileWriter& out         = *open_result;
+  const bool face_normals = recompute_normals || model.normals.empty();
+
+  out.append("solid model\n");
+
+  write_formatted_chunks(
+      out, num_faces, triangles_per_chunk, num_threads, [&](TextBuffer& buffer, std::size_t first, std::size_t last) {
+        if (face_normals) {
+          std::array<glm::vec3, triangles_per_chunk> normals;
+          FaceNormalEngine::best().compute_faces(
+              model, last - first, [&](std::size_t i) -> decltype(auto) { return face(first + i); }, normals.data());
+
+          for (std::size_t i = first; i < last; ++i) {
+            append_triangle(buffer, normals[i - first], model, face(i));
+          }
+        } else {
+          for (std::size_t i = first; i < last; ++i) {
+            const std::array<glm::ivec3, 3>& triangle = face(i);
+            append_triangle(buffer, triangle_normal(model, triangle), model, triangle);
+          }
+        }
+      });
+
+  out.append("endsolid model\n");
+
+  return out.close();
+}
@@ -0,0 +1,40 @@
+#ifndef PRINTER_ASCII_STL_PRINTER_HPP
+#define PRINTER_ASCII_STL_PRINTER_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "../Types/Model.hpp"
+#include "ModelPrinter.hpp"
+
+// Text version of STL, for tools that can't read the binary one. The numbers are written in their shortest form that
+// reads back to the same float, so no precision is lost compared to binary STL
+class AsciiSTLPrinter : public ModelPrinter {
+ public:
+  virtual bool print(const Model& model, const std::string& path) override final;
+
+  // Indexes the positions and normals through the compact faces, without expanding them
+  virtual bool print_compact(const Model& model, const CompactFaces& faces, const std::string& path) override final;
+  virtual bool prints_compact_faces() const override final { return true; }
+
+  // STL has no texture coordinates, only the normals are written (unless they are recomputed)
+  virtual ModelAttributes required_attributes() const override final { return {false, !recompute_normals}; }
+
+  // Same as STLPrinter::set_recompute_normals
+  void set_recompute_normals(bool recompute_normals);
+
+  // Number of threads formatting the triangles (0 means all hardware threads). The output doesn't depend on it
+  void set_num_threads(std::size_t num_threads);
+
+  virtual ~AsciiSTLPrinter() {}
+
+ private:
+  // Prints num_faces faces, face(i) gives the i-th one in the layout of Model::triangular_faces
+  template <class Faces>
+  bool print_faces(const Model& model, std::size_t num_faces, const Faces& face, const std::string& path);
+
+  std::size_t num_threads = 0;
+  bool recompute_normals  = false;
+};
+
+#endif
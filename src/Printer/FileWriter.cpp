@@ -0,0 +1,128 @@
+#include "FileWriter.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+std::optional<FileWriter> FileWriter::open(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    return std::nullopt;
+  }
+
+  return FileWriter{fd};
+}
+
+FileWriter::FileWriter(int fd) : fd{fd}, buffer(buffer_size) {}
+
+FileWriter::FileWriter(FileWriter&& other) noexcept
+    : fd{std::exchange(other.fd, -1)},
+      buffer{std::move(other.buffer)},
+      buffer_used{std::exchange(other.buffer_used, 0)},
+      failed{other.failed} {}
+
+FileWriter& FileWriter::operator=(FileWriter&& other) noexcept {
+  if (this != &other) {
+    close();
+    fd          = std::exchange(other.fd, -1);
+    buffer      = std::move(other.buffer);
+    buffer_used = std::exchange(other.buffer_used, 0);
+    failed      = other.failed;
+  }
+
+  return *this;
+}
+
+FileWriter::~FileWriter() { close(); }
+
+char* FileWriter::append(std::size_t size) {
+  if (buffer_used + size > buffer.size()) {
+    flush();
+  }
+
+  char* space = buffer.data() + buffer_used;
+  buffer_used += size;
+
+  return space;
+}
+
+void FileWriter::append(const void* data, std::size_t size) {
+  // Large blocks would only be copied into the buffer to be written right away
+  if (size >= buffer.size()) {
+    flush();
+    write_all(static_cast<const char*>(data), size);
+    return;
+  }
+
+  std::memcpy(append(size), data, size);
+}
+
+void FileWriter::append(std::string_view text) { append(text.data(), text.size()); }
+
+bool FileWriter::flush() {
+  const std::size_t size = std::exchange(buffer_used, 0);
+  return write_all(buffer.data(), size);
+}
+
+bool FileWriter::write_at(std::size_t offset, const void* data, std::size_t size) {
+  if (!flush()) {
+    return false;
+  }
+
+  const char* it = static_cast<const char*>(data);
+  while (size > 0) {
+    const ssize_t written = ::pwrite(fd, it, size, static_cast<off_t>(offset));
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      failed = true;
+      return false;
+    }
+
+    it += written;
+    offset += written;
+    size -= written;
+  }
+
+  return true;
+}
+
+bool FileWriter::close() {
+  if (fd == -1) {
+    return !failed;
+  }
+
+  flush();
+  if (::close(std::exchange(fd, -1)) != 0) {
+    failed = true;
+  }
+
+  return !failed;
+}
+
+bool FileWriter::write_all(const char* data, std::size_t size) {
+  if (failed || fd == -1) {
+    failed = true;
+    return false;
+  }
+
+  while (size > 0) {
+    const ssize_t written = ::write(fd, data, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      failed = true;
+      return false;
+    }
+
+    data += written;
+    size -= written;
+  }
+
+  return true;
+}
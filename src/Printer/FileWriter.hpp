@@ -0,0 +1,55 @@
+#ifndef PRINTER_FILE_WRITER_HPP
+#define PRINTER_FILE_WRITER_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Buffered output to a file descriptor. Small appends are collected in a large buffer, which is written with a single
+// write(2) call when it's full, so the per-call cost of streams (sentries, locale) is only paid once per megabyte
+// Errors are sticky: after a failed write every operation fails, close reports it
+class FileWriter {
+ public:
+  // Creates or truncates the file at path
+  static std::optional<FileWriter> open(const std::string& path);
+
+  FileWriter(FileWriter&& other) noexcept;
+  FileWriter& operator=(FileWriter&& other) noexcept;
+
+  FileWriter(const FileWriter&) = delete;
+  FileWriter& operator=(const FileWriter&) = delete;
+
+  // Closes the file without reporting errors, call close to check them
+  ~FileWriter();
+
+  // Returns size bytes of buffer space to be filled by the caller, they are written with the next flush
+  // size can't be larger than buffer_size
+  char* append(std::size_t size);
+  void append(const void* data, std::size_t size);
+  void append(std::string_view text);
+
+  bool flush();
+
+  // Overwrites already written bytes at offset (eg. a header that wasn't known at the beginning)
+  // The buffer is flushed first, so offset can point anywhere in the file
+  bool write_at(std::size_t offset, const void* data, std::size_t size);
+
+  // Flushes and closes the file. Returns false if anything written to the file was lost
+  bool close();
+
+  static constexpr std::size_t buffer_size = 1 << 20;
+
+ private:
+  explicit FileWriter(int fd);
+
+  bool write_all(const char* data, std::size_t size);
+
+  int fd = -1;
+  std::vector<char> buffer;
+  std::size_t buffer_used = 0;
+  bool failed             = false;
+};
+
+#endif
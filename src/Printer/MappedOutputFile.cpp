@@ -0,0 +1,83 @@
+#include "MappedOutputFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <utility>
+
+namespace {
+// Resizes the empty file at fd to size bytes. The blocks are allocated right away where the file system supports it,
+// so running out of space is an error here, instead of a SIGBUS when the mapping is written
+bool allocate(int fd, std::size_t size) {
+  if (size == 0 || ::fallocate(fd, 0, 0, static_cast<off_t>(size)) == 0) {
+    return true;
+  }
+
+  return errno != ENOSPC && ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+}
+}  // namespace
+
+std::optional<MappedOutputFile> MappedOutputFile::create(const std::string& path, std::size_t size) {
+  // The mapping has to be readable and writable, a write only descriptor can't be mapped
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    return std::nullopt;
+  }
+
+  struct stat file_info;
+  if (::fstat(fd, &file_info) != 0 || !S_ISREG(file_info.st_mode) || ::ftruncate(fd, 0) != 0 ||
+      !allocate(fd, size)) {
+    ::close(fd);
+    return std::nullopt;
+  }
+
+  // mmap can't map 0 bytes, an empty file doesn't need a mapping
+  if (size == 0) {
+    return MappedOutputFile{fd, nullptr, 0};
+  }
+
+  void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    ::close(fd);
+    return std::nullopt;
+  }
+
+  return MappedOutputFile{fd, mapping, size};
+}
+
+MappedOutputFile::MappedOutputFile(int fd, void* mapping, std::size_t size)
+    : fd{fd}, mapping{mapping}, mapping_size{size} {}
+
+MappedOutputFile::MappedOutputFile(MappedOutputFile&& other) noexcept
+    : fd{std::exchange(other.fd, -1)},
+      mapping{std::exchange(other.mapping, nullptr)},
+      mapping_size{std::exchange(other.mapping_size, 0)} {}
+
+MappedOutputFile& MappedOutputFile::operator=(MappedOutputFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    fd           = std::exchange(other.fd, -1);
+    mapping      = std::exchange(other.mapping, nullptr);
+    mapping_size = std::exchange(other.mapping_size, 0);
+  }
+
+  return *this;
+}
+
+MappedOutputFile::~MappedOutputFile() { close(); }
+
+bool MappedOutputFile::close() {
+  bool success = true;
+
+  if (mapping) {
+    success = ::munmap(std::exchange(mapping, nullptr), std::exchange(mapping_size, 0)) == 0;
+  }
+  if (fd != -1) {
+    success = ::close(std::exchange(fd, -1)) == 0 && success;
+  }
+
+  return success;
+}
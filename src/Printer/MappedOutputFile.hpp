@@ -0,0 +1,39 @@
+#ifndef PRINTER_MAPPED_OUTPUT_FILE_HPP
+#define PRINTER_MAPPED_OUTPUT_FILE_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+// Writable shared memory mapping of a new file with a size known up front. Different parts of it can be filled by
+// different threads at the same time. Only regular files can be mapped, for anything else (pipes, character devices)
+// create returns nullopt, so the caller can fall back to writing sequentially
+class MappedOutputFile {
+ public:
+  // Creates or truncates the file at path and resizes it to size bytes
+  static std::optional<MappedOutputFile> create(const std::string& path, std::size_t size);
+
+  MappedOutputFile(MappedOutputFile&& other) noexcept;
+  MappedOutputFile& operator=(MappedOutputFile&& other) noexcept;
+
+  MappedOutputFile(const MappedOutputFile&) = delete;
+  MappedOutputFile& operator=(const MappedOutputFile&) = delete;
+
+  // Unmaps the file without reporting errors, call close to check them
+  ~MappedOutputFile();
+
+  char* data() const { return static_cast<char*>(mapping); }
+  std::size_t size() const { return mapping_size; }
+
+  // Unmaps and closes the file. The contents are written back by the kernel like any other write
+  bool close();
+
+ private:
+  MappedOutputFile(int fd, void* mapping, std::size_t size);
+
+  int fd                   = -1;
+  void* mapping            = nullptr;
+  std::size_t mapping_size = 0;
+};
+
+#endif
@@ -15,3 +15,31 @@ std::optional<std::ofstream> ModelPrinter::open_file(const std::string& path) co
 
   return std::optional(std::move(out));
 }
+
+std::optional<FileWriter> ModelPrinter::open_writer(const std::string& path) const {
+  auto writer = FileWriter::open(path);
+
+  if (!writer) {
+    std::cerr << "Could not open file for writing " << path << "\n";
+  }
+
+  return writer;
+}
+
+bool ModelPrinter::print_compact(const Model& model, const CompactFaces& faces, const std::string& path) {
+  const ModelAttributes required = required_attributes();
+
+  Model expanded{0};
+  expanded.positions = model.positions;
+  if (required.texture_coords) {
+    expanded.texture_coords = model.texture_coords;
+  }
+  if (required.normals) {
+    expanded.normals = model.normals;
+  }
+  expanded.triangular_faces = expand_faces(faces);
+
+  return print(expanded, path);
+}
+
+std::unique_ptr<FaceSink> ModelPrinter::open_sink(const std::string&) { return nullptr; }
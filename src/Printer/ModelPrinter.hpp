@@ -2,19 +2,40 @@
 #define PRINTER_MODEL_PRINTER_HPP
 
 #include <fstream>
+#include <memory>
 #include <optional>
 #include <string>
 
+#include "../Types/CompactFaces.hpp"
+#include "../Types/FaceSink.hpp"
 #include "../Types/Model.hpp"
+#include "FileWriter.hpp"
 
 class ModelPrinter {
  public:
   virtual bool print(const Model& model, const std::string& path) = 0;
 
+  // Prints model with faces instead of model.triangular_faces. The PLY and STL printers override it with loops over
+  // the compact faces, the default copies the positions and the faces expanded (and the attributes the printer needs)
+  virtual bool print_compact(const Model& model, const CompactFaces& faces, const std::string& path);
+
+  // Whether print_compact loops over the compact faces without expanding them, so converting the faces of a model to
+  // compact faces before printing it saves memory
+  virtual bool prints_compact_faces() const { return false; }
+
+  // Opens path for writing faces one by one, as they are parsed. Returns nullptr if the printer needs the whole model
+  // at once (that's the default) or if the file couldn't be opened
+  virtual std::unique_ptr<FaceSink> open_sink(const std::string& path);
+
+  // The attributes print reads, so parsers can skip the rest. The default is all of them
+  virtual ModelAttributes required_attributes() const { return ModelAttributes(); }
+
   virtual ~ModelPrinter() {}
 
  protected:
   virtual std::optional<std::ofstream> open_file(const std::string& path) const;
+  // Same as open_file, for printers that write large blocks of raw bytes
+  virtual std::optional<FileWriter> open_writer(const std::string& path) const;
 };
 
 #endif
\ No newline at end of file
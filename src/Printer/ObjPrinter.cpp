@@ -0,0 +1,101 @@
+#include <array>
+
+#include "../Types/Model.hpp"
+#include "ObjPrinter.hpp"
+#include "TextBuffer.hpp"
+
+namespace {
+// Lines formatted by one task, one to a few megabytes of text
+const std::size_t lines_per_chunk = 65536;
+
+// Writes the 1-based indices of a vertex, leaving out the missing ones: "1", "1/2", "1//3" or "1/2/3"
+void append_vertex(TextBuffer& buffer, const glm::ivec3& vertex) {
+  buffer.append(vertex.x + 1);
+
+  if (vertex.y >= 0 || vertex.z >= 0) {
+    buffer.append('/');
+  }
+  if (vertex.y >= 0) {
+    buffer.append(vertex.y + 1);
+  }
+  if (vertex.z >= 0) {
+    buffer.append('/');
+    buffer.append(vertex.z + 1);
+  }
+}
+
+// Formats the lines of one kind of element in parallel, append_line(buffer, element) formats one of them
+template <class Element, class AppendLine>
+void write_lines(FileWriter& out,
+                 const std::vector<Element>& elements,
+                 std::size_t num_threads,
+                 AppendLine&& append_line) {
+  write_formatted_chunks(
+      out, elements.size(), lines_per_chunk, num_threads, [&](TextBuffer& buffer, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+          append_line(buffer, elements[i]);
+        }
+      });
+}
+}  // namespace
+
+void ObjPrinter::set_num_threads(std::size_t num_threads) { this->num_threads = num_threads; }
+
+bool ObjPrinter::print(const Model& model, const std::string& path) {
+  auto open_result = open_writer(path);
+  if (!open_result) {
+    return false;
+  }
+
+  FileWriter& out = *open_result;
+
+  // The default values (w = 1, texture y and z = 0) are left out, like most exporters do
+  write_lines(out, model.positions, num_threads, [](TextBuffer& buffer, const glm::vec4& position) {
+    buffer.append("v ");
+    buffer.append(position.x);
+    buffer.append(' ');
+    buffer.append(position.y);
+    buffer.append(' ');
+    buffer.append(position.z);
+    if (position.w != 1.0f) {
+      buffer.append(' ');
+      buffer.append(position.w);
+    }
+    buffer.append('\n');
+  });
+
+  write_lines(out, model.texture_coords, num_threads, [](TextBuffer& buffer, const glm::vec3& texture) {
+    buffer.append("vt ");
+    buffer.append(texture.x);
+    if (texture.y != 0.0f || texture.z != 0.0f) {
+      buffer.append(' ');
+      buffer.append(texture.y);
+    }
+    if (texture.z != 0.0f) {
+      buffer.append(' ');
+      buffer.append(texture.z);
+    }
+    buffer.append('\n');
+  });
+
+  write_lines(out, model.normals, num_threads, [](TextBuffer& buffer, const glm::vec3& normal) {
+    buffer.append("vn ");
+    buffer.append(normal.x);
+    buffer.append(' ');
+    buffer.append(normal.y);
+    buffer.append(' ');
+    buffer.append(normal.z);
+    buffer.append('\n');
+  });
+
+  write_lines(out, model.triangular_faces, num_threads, [](TextBuffer& buffer, const std::array<glm::ivec3, 3>& face) {
+    buffer.append('f');
+    for (const auto& vertex : face) {
+      buffer.append(' ');
+      append_vertex(buffer, vertex);
+    }
+    buffer.append('\n');
+  });
+
+  return out.close();
+}
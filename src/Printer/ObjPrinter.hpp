@@ -0,0 +1,25 @@
+#ifndef PRINTER_OBJ_PRINTER_HPP
+#define PRINTER_OBJ_PRINTER_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "../Types/Model.hpp"
+#include "ModelPrinter.hpp"
+
+// Writes the model back to OBJ: the v, vt and vn lines, then the triangles as f lines. Numbers are written in their
+// shortest form that reads back to the same value, so parsing the output gives the same model
+class ObjPrinter : public ModelPrinter {
+ public:
+  virtual bool print(const Model& model, const std::string& path) override final;
+
+  // Number of threads formatting the lines (0 means all hardware threads). The output doesn't depend on it
+  void set_num_threads(std::size_t num_threads);
+
+  virtual ~ObjPrinter() {}
+
+ private:
+  std::size_t num_threads = 0;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <variant>
+
+#include "../Types/Model.hpp"
+#include "PLYPrinter.hpp"
+
+namespace {
+const std::size_t vertex_size = 3 * sizeof(float);
+// The number of indices as uchar, then the 3 indices
+const std::size_t face_size = sizeof(std::uint8_t) + 3 * sizeof(std::int32_t);
+
+// Packs count elements at a time straight into the writer's buffer, pack(record, element) fills one record
+template <class Element, class Pack>
+void write_records(FileWriter& out, const std::vector<Element>& elements, std::size_t record_size, Pack&& pack) {
+  const std::size_t records_per_block = FileWriter::buffer_size / record_size;
+
+  for (std::size_t first = 0; first < elements.size(); first += records_per_block) {
+    const std::size_t count = std::min(records_per_block, elements.size() - first);
+    char* record            = out.append(count * record_size);
+
+    for (std::size_t i = first; i < first + count; ++i, record += record_size) {
+      pack(record, elements[i]);
+    }
+  }
+}
+
+// Packs a face with 3 position indices of any integer type
+template <class Index>
+void pack_face(char* record, Index a, Index b, Index c) {
+  const std::int32_t indices[3] = {
+      static_cast<std::int32_t>(a), static_cast<std::int32_t>(b), static_cast<std::int32_t>(c)};
+  record[0] = 3;
+  std::memcpy(record + 1, indices, sizeof(indices));
+}
+}  // namespace
+
+template <class WriteFaces>
+bool PLYPrinter::print_with_faces(const Model& model,
+                                  std::size_t face_count,
+                                  const std::string& path,
+                                  WriteFaces&& write_faces) {
+  auto open_result = open_writer(path);
+  if (!open_result) {
+    return false;
+  }
+
+  FileWriter& out = *open_result;
+
+  // Like STLPrinter, the numbers are written in the byte order of the host, which has to be little-endian
+  const std::string header = "ply\n"
+                             "format binary_little_endian 1.0\n"
+                             "element vertex " +
+                             std::to_string(model.positions.size()) +
+                             "\n"
+                             "property float x\n"
+                             "property float y\n"
+                             "property float z\n"
+                             "element face " +
+                             std::to_string(face_count) +
+                             "\n"
+                             "property list uchar int vertex_indices\n"
+                             "end_header\n";
+  out.append(header.data(), header.size());
+
+  // Only x, y and z are written. If homogenous coordinate support is desired, we could divide them by w
+  write_records(out, model.positions, vertex_size, [](char* record, const glm::vec4& position) {
+    std::memcpy(record, &position.x, vertex_size);
+  });
+
+  write_faces(out);
+
+  return out.close();
+}
+
+bool PLYPrinter::print(const Model& model, const std::string& path) {
+  return print_with_faces(model, model.triangular_faces.size(), path, [&](FileWriter& out) {
+    write_records(out, model.triangular_faces, face_size, [](char* record, const std::array<glm::ivec3, 3>& face) {
+      pack_face(record, face[0].x, face[1].x, face[2].x);
+    });
+  });
+}
+
+bool PLYPrinter::print_compact(const Model& model, const CompactFaces& faces, const std::string& path) {
+  return print_with_faces(model, num_faces(faces), path, [&](FileWriter& out) {
+    std::visit(
+        [&](const auto& alternative) {
+          write_records(out, alternative.positions, face_size, [](char* record, const auto& face) {
+            pack_face(record, face[0], face[1], face[2]);
+          });
+        },
+        faces);
+  });
+}
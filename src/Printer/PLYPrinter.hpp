@@ -0,0 +1,32 @@
+#ifndef PRINTER_PLY_PRINTER_HPP
+#define PRINTER_PLY_PRINTER_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "../Types/CompactFaces.hpp"
+#include "../Types/Model.hpp"
+#include "ModelPrinter.hpp"
+
+// Writes binary little-endian PLY: the positions as float x, y, z and the triangles as lists of 3 int indices
+// Unlike STL the vertices are stored once and referenced by index, so files are about a third of the size
+class PLYPrinter : public ModelPrinter {
+ public:
+  virtual bool print(const Model& model, const std::string& path) override final;
+
+  // Writes the position indices of faces, whichever alternative they are in
+  virtual bool print_compact(const Model& model, const CompactFaces& faces, const std::string& path) override final;
+  virtual bool prints_compact_faces() const override final { return true; }
+
+  // Only the positions and the faces are written
+  virtual ModelAttributes required_attributes() const override final { return {false, false}; }
+
+  virtual ~PLYPrinter() {}
+
+ private:
+  // Writes the header and the positions, then write_faces(out) writes face_count faces
+  template <class WriteFaces>
+  bool print_with_faces(const Model& model, std::size_t face_count, const std::string& path, WriteFaces&& write_faces);
+};
+
+#endif
@@ -1,55 +1,211 @@
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <optional>
+#include <variant>
+#include <vector>
 
+#include "../Computations/FaceNormals.hpp"
+#include "../Parallel/Parallel.hpp"
 #include "../Types/Model.hpp"
+#include "MappedOutputFile.hpp"
 #include "STLPrinter.hpp"
 
 namespace {
-std::ostream& operator<<(std::ostream& out, const glm::vec3& vec) {
-  out.write(reinterpret_cast<const char*>(&vec.x), sizeof(float));
-  out.write(reinterpret_cast<const char*>(&vec.y), sizeof(float));
-  out.write(reinterpret_cast<const char*>(&vec.z), sizeof(float));
+const std::size_t header_size = 80;
+// Normal, 3 positions and the attribute byte count
+const std::size_t triangle_size = 4 * 3 * sizeof(float) + sizeof(uint16_t);
 
-  return out;
+// Triangles are packed in blocks of this many, one writer buffer or one parallel task at a time
+const std::size_t triangles_per_block = FileWriter::buffer_size / triangle_size;
+
+// Fills the header_size + 4 bytes at header with the STL header
+void pack_header(char* header, uint32_t num_of_faces) {
+  std::memset(header, ' ', header_size);
+  std::memcpy(header + header_size, &num_of_faces, sizeof(uint32_t));
+}
+
+void write_header(FileWriter& out, uint32_t num_of_faces) {
+  pack_header(out.append(header_size + sizeof(uint32_t)), num_of_faces);
+}
+
+// Only x, y and z are written. If homogenous coordinate support is desired, we could divide them by w
+template <class Vector>
+char* pack_vector(char* record, const Vector& vec) {
+  std::memcpy(record, &vec.x, sizeof(float));
+  std::memcpy(record + sizeof(float), &vec.y, sizeof(float));
+  std::memcpy(record + 2 * sizeof(float), &vec.z, sizeof(float));
+
+  return record + 3 * sizeof(float);
 }
 
-// Same as vec3, we just ignore the fourth parameter
-// If homogenous coordinate support is desired, we could divide each element by the w component
-std::ostream& operator<<(std::ostream& out, const glm::vec4& vec) {
-  out.write(reinterpret_cast<const char*>(&vec.x), sizeof(float));
-  out.write(reinterpret_cast<const char*>(&vec.y), sizeof(float));
-  out.write(reinterpret_cast<const char*>(&vec.z), sizeof(float));
+// Fills the triangle_size bytes at record with the STL representation of face
+void pack_triangle(char* record, const glm::vec3& normal, const Model& model, const std::array<glm::ivec3, 3>& face) {
+  const uint16_t attrib_byte_cnt = 0;
 
-  return out;
+  record = pack_vector(record, normal);
+  record = pack_vector(record, model.positions[face[0].x]);
+  record = pack_vector(record, model.positions[face[1].x]);
+  record = pack_vector(record, model.positions[face[2].x]);
+
+  std::memcpy(record, &attrib_byte_cnt, sizeof(uint16_t));
+}
+
+// Fills count records starting at records with the faces [first, first + count), face(i) gives the i-th one
+// With face_normals the facet normals are written, computed for the whole block at once, instead of the stored ones
+template <class Faces>
+void pack_triangles(
+    char* records, const Model& model, const Faces& face, std::size_t first, std::size_t count, bool face_normals) {
+  if (face_normals) {
+    std::vector<glm::vec3> normals(count);
+    FaceNormalEngine::best().compute_faces(
+        model, count, [&](std::size_t i) -> decltype(auto) { return face(first + i); }, normals.data());
+
+    for (std::size_t i = 0; i < count; ++i, records += triangle_size) {
+      pack_triangle(records, normals[i], model, face(first + i));
+    }
+  } else {
+    for (std::size_t i = first; i < first + count; ++i, records += triangle_size) {
+      const std::array<glm::ivec3, 3>& triangle = face(i);
+      pack_triangle(records, triangle_normal(model, triangle), model, triangle);
+    }
+  }
 }
+
+// Writes the triangles as they are parsed. The triangle count isn't known until the end, so the header gets a
+// placeholder first, which is overwritten in finish
+class STLFaceSink : public FaceSink {
+ public:
+  STLFaceSink(FileWriter&& out, bool face_normals) : out{std::move(out)}, face_normals{face_normals} {
+    write_header(this->out, 0);
+  }
+
+  virtual bool add_face(const Model& model, const std::array<glm::ivec3, 3>& face) override {
+    // The referenced attributes must have been parsed before the face, we can't go back for them later
+    for (const auto& vertex : face) {
+      const bool position_defined = vertex.x >= 0 && static_cast<std::size_t>(vertex.x) < model.positions.size();
+      // -1 means there is no normal, that's fine
+      const bool normal_defined = vertex.z >= -1 && static_cast<std::size_t>(vertex.z + 1) <= model.normals.size();
+
+      if (!position_defined || !normal_defined) {
+        std::cerr << "Face refers to a vertex that isn't defined before it, it can't be streamed\n";
+        return false;
+      }
+    }
+
+    // The header counts the faces in 32 bits
+    if (num_of_faces == std::numeric_limits<uint32_t>::max()) {
+      std::cerr << "The model has too many triangles for an STL file\n";
+      return false;
+    }
+
+    const glm::vec3 normal = face_normals ? face_normal(model, face) : triangle_normal(model, face);
+    pack_triangle(out.append(triangle_size), normal, model, face);
+    ++num_of_faces;
+
+    return true;
+  }
+
+  virtual bool finish() override {
+    out.write_at(header_size, &num_of_faces, sizeof(uint32_t));
+    return out.close();
+  }
+
+ private:
+  FileWriter out;
+  bool face_normals;
+  uint32_t num_of_faces = 0;
+};
 }  // namespace
 
+void STLPrinter::set_recompute_normals(bool recompute_normals) { this->recompute_normals = recompute_normals; }
+
+void STLPrinter::set_num_threads(std::size_t num_threads) { this->num_threads = num_threads; }
+
 bool STLPrinter::print(const Model& model, const std::string& path) {
-  auto open_result = open_file(path);
+  return print_faces(
+      model,
+      model.triangular_faces.size(),
+      [&](std::size_t i) -> const auto& { return model.triangular_faces[i]; },
+      path);
+}
+
+bool STLPrinter::print_compact(const Model& model, const CompactFaces& faces, const std::string& path) {
+  return std::visit(
+      [&](const auto& alternative) {
+        return print_faces(
+            model, alternative.positions.size(), [&](std::size_t i) { return expand_face(alternative, i); }, path);
+      },
+      faces);
+}
+
+template <class Faces>
+bool STLPrinter::print_faces(const Model& model, std::size_t num_faces, const Faces& face, const std::string& path) {
+  // The header counts the faces in 32 bits
+  if (num_faces > std::numeric_limits<uint32_t>::max()) {
+    std::cerr << "The model has too many triangles for an STL file\n";
+    return false;
+  }
+
+  // Every triangle has a fixed place in the file, so blocks of them can be written by different threads. Outputs that
+  // can't be mapped (like pipes) are written sequentially
+  const std::size_t num_blocks = (num_faces + triangles_per_block - 1) / triangles_per_block;
+  if (num_blocks > 1 && resolve_thread_count(num_threads) > 1) {
+    const std::size_t file_size = header_size + sizeof(uint32_t) + num_faces * triangle_size;
+    if (auto mapped_file = MappedOutputFile::create(path, file_size); mapped_file) {
+      return print_mapped(model, num_faces, face, *mapped_file, num_blocks);
+    }
+  }
+
+  auto open_result = open_writer(path);
   if (!open_result) {
     return false;
   }
 
-  uint16_t attrib_byte_cnt = 0;
-  std::ofstream& out       = *open_result;
+  FileWriter& out = *open_result;
 
-  std::array<char, 80> header;
-  header.fill(' ');
-  out.write(reinterpret_cast<const char*>(header.data()), header.size());
+  write_header(out, static_cast<uint32_t>(num_faces));
 
-  uint32_t num_of_faces = model.triangular_faces.size();
+  // Records are packed straight into the writer's buffer, a buffer's worth of triangles at a time
+  const bool face_normals = use_face_normals(model);
 
-  out.write(reinterpret_cast<const char*>(&num_of_faces), sizeof(uint32_t));
+  for (std::size_t first = 0; first < num_faces; first += triangles_per_block) {
+    const std::size_t count = std::min(triangles_per_block, num_faces - first);
+    pack_triangles(out.append(count * triangle_size), model, face, first, count, face_normals);
+  }
+
+  return out.close();
+}
+
+template <class Faces>
+bool STLPrinter::print_mapped(
+    const Model& model, std::size_t num_faces, const Faces& face, MappedOutputFile& out, std::size_t num_blocks) {
+  const bool face_normals = use_face_normals(model);
+  char* const triangles   = out.data() + header_size + sizeof(uint32_t);
+
+  pack_header(out.data(), static_cast<uint32_t>(num_faces));
 
-  for (const auto& face : model.triangular_faces) {
-    // Take the normal vector of the first vertex of the triangle
-    // All 3 should have the same normal vector
-    out << model.normals[face[0].z];
-    out << model.positions[face[0].x] << model.positions[face[1].x] << model.positions[face[2].x];
+  parallel_for(num_blocks, num_threads, [&](std::size_t block) {
+    const std::size_t first = block * triangles_per_block;
+    const std::size_t count = std::min(triangles_per_block, num_faces - first);
 
-    out.write(reinterpret_cast<const char*>(&attrib_byte_cnt), sizeof(uint16_t));
+    pack_triangles(triangles + first * triangle_size, model, face, first, count, face_normals);
+  });
+
+  return out.close();
+}
+
+std::unique_ptr<FaceSink> STLPrinter::open_sink(const std::string& path) {
+  auto open_result = open_writer(path);
+  if (!open_result) {
+    return nullptr;
   }
 
-  return true;
+  return std::make_unique<STLFaceSink>(std::move(*open_result), recompute_normals);
 }
+
+bool STLPrinter::use_face_normals(const Model& model) const { return recompute_normals || model.normals.empty(); }
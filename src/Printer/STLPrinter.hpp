@@ -1,16 +1,51 @@
 #ifndef PRINTER_STL_PRINTER_HPP
 #define PRINTER_STL_PRINTER_HPP
 
+#include <cstddef>
 #include <string>
 
 #include "../Types/Model.hpp"
+#include "MappedOutputFile.hpp"
 #include "ModelPrinter.hpp"
 
 class STLPrinter : public ModelPrinter {
  public:
   virtual bool print(const Model& model, const std::string& path) override final;
 
+  // Indexes the positions and normals through the compact faces, without expanding them
+  virtual bool print_compact(const Model& model, const CompactFaces& faces, const std::string& path) override final;
+  virtual bool prints_compact_faces() const override final { return true; }
+
+  // Writes the triangles as they arrive and fills in the triangle count of the header when the sink is finished
+  virtual std::unique_ptr<FaceSink> open_sink(const std::string& path) override final;
+
+  // STL has no texture coordinates, only the normals are written (unless they are recomputed)
+  virtual ModelAttributes required_attributes() const override final { return {false, !recompute_normals}; }
+
+  // Write the facet normals computed from the positions instead of the normals of the model, for models whose normals
+  // can't be trusted. Facet normals are also written for models without normals and for faces without a normal index
+  void set_recompute_normals(bool recompute_normals);
+
+  // Number of threads print uses for large models (0 means all hardware threads). They fill a memory mapping of the
+  // output file, the result is the same as writing it with one thread
+  void set_num_threads(std::size_t num_threads);
+
   virtual ~STLPrinter() {}
+
+ private:
+  // Prints num_faces faces, face(i) gives the i-th one in the layout of Model::triangular_faces
+  template <class Faces>
+  bool print_faces(const Model& model, std::size_t num_faces, const Faces& face, const std::string& path);
+
+  template <class Faces>
+  bool print_mapped(
+      const Model& model, std::size_t num_faces, const Faces& face, MappedOutputFile& out, std::size_t num_blocks);
+
+  // Whether the normals of all triangles are computed in blocks by the face normal engine
+  bool use_face_normals(const Model& model) const;
+
+  std::size_t num_threads = 0;
+  bool recompute_normals  = false;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef PRINTER_TEXT_BUFFER_HPP
+#define PRINTER_TEXT_BUFFER_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../Parallel/Parallel.hpp"
+#include "FileWriter.hpp"
+
+// Growing buffer of text with number formatting that doesn't allocate (std::to_chars, floats are written in their
+// shortest form that reads back to the same value). clear keeps the memory, so a reused buffer stops allocating
+class TextBuffer {
+ public:
+  void append(std::string_view text) {
+    char* end = reserve(text.size());
+    std::copy(text.begin(), text.end(), end);
+    used += text.size();
+  }
+
+  void append(char ch) {
+    *reserve(1) = ch;
+    ++used;
+  }
+
+  // Any int or float, the longest ones take less than max_number_size characters
+  template <class Number, class = std::enable_if_t<std::is_arithmetic_v<Number>>>
+  void append(Number number) {
+    char* end = reserve(max_number_size);
+    used      = std::to_chars(end, end + max_number_size, number).ptr - data.data();
+  }
+
+  std::string_view view() const { return std::string_view{data.data(), used}; }
+  void clear() { used = 0; }
+
+ private:
+  static constexpr std::size_t max_number_size = 32;
+
+  // Makes room for size more characters and returns where they go
+  char* reserve(std::size_t size) {
+    if (used + size > data.size()) {
+      data.resize(std::max(2 * data.size(), used + size));
+    }
+
+    return data.data() + used;
+  }
+
+  std::vector<char> data;
+  std::size_t used = 0;
+};
+
+// Formats num_items items in chunks of chunk_size on num_threads threads (0 means all hardware threads) and writes them
+// to out in order, so the output is the same for any number of threads. format(buffer, first, last) appends the text
+// of the items [first, last) to buffer. Only a few chunks per thread are kept in memory at a time
+template <class Format>
+void write_formatted_chunks(FileWriter& out,
+                            std::size_t num_items,
+                            std::size_t chunk_size,
+                            std::size_t num_threads,
+                            Format&& format) {
+  const std::size_t num_chunks = (num_items + chunk_size - 1) / chunk_size;
+  std::vector<TextBuffer> buffers(std::min(num_chunks, 4 * resolve_thread_count(num_threads)));
+
+  for (std::size_t first_chunk = 0; first_chunk < num_chunks; first_chunk += buffers.size()) {
+    const std::size_t round_size = std::min(buffers.size(), num_chunks - first_chunk);
+
+    parallel_for(round_size, num_threads, [&](std::size_t i) {
+      const std::size_t first = (first_chunk + i) * chunk_size;
+
+      buffers[i].clear();
+      format(buffers[i], first, std::min(first + chunk_size, num_items));
+    });
+
+    for (std::size_t i = 0; i < round_size; ++i) {
+      out.append(buffers[i].view().data(), buffers[i].view().size());
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include "CompactFaces.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+template <class Index>
+PositionFaces<Index> make_position_faces(const Model& model) {
+  PositionFaces<Index> faces;
+  faces.positions.reserve(model.triangular_faces.size());
+
+  for (const auto& face : model.triangular_faces) {
+    faces.positions.push_back(
+        {static_cast<Index>(face[0].x), static_cast<Index>(face[1].x), static_cast<Index>(face[2].x)});
+  }
+
+  return faces;
+}
+
+// The stream of one attribute (1 is texture coordinates, 2 is normals), empty if no face uses it
+std::vector<std::array<std::int32_t, 3>> make_attribute_stream(const Model& model, int attribute) {
+  const bool used = std::any_of(model.triangular_faces.begin(), model.triangular_faces.end(), [&](const auto& face) {
+    return face[0][attribute] != -1 || face[1][attribute] != -1 || face[2][attribute] != -1;
+  });
+
+  std::vector<std::array<std::int32_t, 3>> stream;
+  if (used) {
+    stream.reserve(model.triangular_faces.size());
+    for (const auto& face : model.triangular_faces) {
+      stream.push_back({face[0][attribute], face[1][attribute], face[2][attribute]});
+    }
+  }
+
+  return stream;
+}
+}  // namespace
+
+CompactFaces compact_faces(const Model& model) {
+  AttributeFaces attribute_faces;
+  attribute_faces.texture_coords = make_attribute_stream(model, 1);
+  attribute_faces.normals        = make_attribute_stream(model, 2);
+
+  if (!attribute_faces.texture_coords.empty() || !attribute_faces.normals.empty()) {
+    attribute_faces.positions = make_position_faces<std::uint32_t>(model).positions;
+    return attribute_faces;
+  }
+
+  if (model.positions.size() <= std::numeric_limits<std::uint16_t>::max()) {
+    return make_position_faces<std::uint16_t>(model);
+  }
+
+  return make_position_faces<std::uint32_t>(model);
+}
+
+std::vector<std::array<glm::ivec3, 3>> expand_faces(const CompactFaces& faces) {
+  std::vector<std::array<glm::ivec3, 3>> result(num_faces(faces));
+
+  std::visit(
+      [&](const auto& alternative) {
+        for (std::size_t i = 0; i < result.size(); ++i) {
+          result[i] = expand_face(alternative, i);
+        }
+      },
+      faces);
+
+  return result;
+}
+
+std::size_t num_faces(const CompactFaces& faces) {
+  return std::visit([](const auto& alternative) { return alternative.positions.size(); }, faces);
+}
+
+bool CompactFaceSink::add_face(const Model& model, const std::array<glm::ivec3, 3>& face) {
+  faces.positions.push_back({static_cast<std::uint32_t>(face[0].x),
+                             static_cast<std::uint32_t>(face[1].x),
+                             static_cast<std::uint32_t>(face[2].x)});
+
+  for (int attribute = 1; attribute <= 2; ++attribute) {
+    auto& stream = attribute == 1 ? faces.texture_coords : faces.normals;
+    // The faces before the first one using the attribute don't have it
+    if (stream.empty() && (face[0][attribute] != -1 || face[1][attribute] != -1 || face[2][attribute] != -1)) {
+      stream.assign(faces.positions.size() - 1, {-1, -1, -1});
+    }
+    if (!stream.empty()) {
+      stream.push_back({face[0][attribute], face[1][attribute], face[2][attribute]});
+    }
+  }
+
+  num_positions = model.positions.size();
+
+  return true;
+}
+
+bool CompactFaceSink::finish() {
+  if (!faces.texture_coords.empty() || !faces.normals.empty()) {
+    result = std::move(faces);
+  } else if (num_positions <= std::numeric_limits<std::uint16_t>::max()) {
+    PositionFaces<std::uint16_t> narrow;
+    narrow.positions.reserve(faces.positions.size());
+    for (const auto& face : faces.positions) {
+      narrow.positions.push_back(
+          {static_cast<std::uint16_t>(face[0]), static_cast<std::uint16_t>(face[1]), static_cast<std::uint16_t>(face[2])});
+    }
+    result = std::move(narrow);
+  } else {
+    result = PositionFaces<std::uint32_t>{std::move(faces.positions)};
+  }
+
+  faces = AttributeFaces();
+
+  return true;
+}
+
+std::size_t memory_size(const CompactFaces& faces) {
+  const auto bytes = [](const auto& stream) { return stream.size() * sizeof(stream[0]); };
+
+  std::size_t size = std::visit([&](const auto& alternative) { return bytes(alternative.positions); }, faces);
+  if (const auto* attribute_faces = std::get_if<AttributeFaces>(&faces)) {
+    size += bytes(attribute_faces->texture_coords) + bytes(attribute_faces->normals);
+  }
+
+  return size;
+}
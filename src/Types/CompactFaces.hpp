@@ -0,0 +1,89 @@
+#ifndef TYPES_COMPACT_FACES_HPP
+#define TYPES_COMPACT_FACES_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "FaceSink.hpp"
+#include "Model.hpp"
+
+// Smaller alternatives to Model::triangular_faces, which takes 36 bytes per triangle even if only the positions are
+// indexed. Every alternative has the position indices in a member called positions, so loops over them can be
+// written once as a template and instantiated for each one with std::visit
+
+// Faces that only index positions: 6 bytes per triangle with std::uint16_t, 12 with std::uint32_t
+template <class Index>
+struct PositionFaces {
+  std::vector<std::array<Index, 3>> positions;
+};
+
+// Faces that index other attributes too, every attribute in a separate stream. The stream of an attribute is empty if
+// no face uses it, otherwise -1 means a missing index like in Model::triangular_faces
+struct AttributeFaces {
+  std::vector<std::array<std::uint32_t, 3>> positions;
+  std::vector<std::array<std::int32_t, 3>> texture_coords;
+  std::vector<std::array<std::int32_t, 3>> normals;
+};
+
+using CompactFaces = std::variant<PositionFaces<std::uint16_t>, PositionFaces<std::uint32_t>, AttributeFaces>;
+
+// Face i of an alternative in the layout of Model::triangular_faces, so printers can loop over the alternative without
+// expanding all the faces first
+template <class Index>
+std::array<glm::ivec3, 3> expand_face(const PositionFaces<Index>& faces, std::size_t i) {
+  const auto& face = faces.positions[i];
+  return {glm::ivec3{static_cast<int>(face[0]), -1, -1},
+          glm::ivec3{static_cast<int>(face[1]), -1, -1},
+          glm::ivec3{static_cast<int>(face[2]), -1, -1}};
+}
+
+inline std::array<glm::ivec3, 3> expand_face(const AttributeFaces& faces, std::size_t i) {
+  std::array<glm::ivec3, 3> face;
+  for (int corner = 0; corner < 3; ++corner) {
+    face[corner] = glm::ivec3{static_cast<int>(faces.positions[i][corner]),
+                              faces.texture_coords.empty() ? -1 : faces.texture_coords[i][corner],
+                              faces.normals.empty() ? -1 : faces.normals[i][corner]};
+  }
+  return face;
+}
+
+// The faces of model in the smallest alternative that holds them: 16 bit indices for less than 65536 positions, and
+// streams only for the attributes some face uses
+CompactFaces compact_faces(const Model& model);
+
+// The faces in the layout of Model::triangular_faces
+std::vector<std::array<glm::ivec3, 3>> expand_faces(const CompactFaces& faces);
+
+std::size_t num_faces(const CompactFaces& faces);
+
+// Bytes used by the indices
+std::size_t memory_size(const CompactFaces& faces);
+
+// Collects the faces of a model as compact faces while it's being parsed, so the faces are never stored in the layout
+// of Model::triangular_faces. The result is the same as compact_faces of the whole model, unless positions come after
+// the last face (they don't count for the 16 bit indices here)
+class CompactFaceSink : public FaceSink {
+ public:
+  virtual bool add_face(const Model& model, const std::array<glm::ivec3, 3>& face) override final;
+
+  // Narrows the position indices to 16 bits if there are few enough positions and no other attribute is used
+  virtual bool finish() override final;
+
+  // The faces collected, after finish
+  CompactFaces take_faces() { return std::move(result); }
+
+  virtual ~CompactFaceSink() {}
+
+ private:
+  // 32 bit position indices until finish, the stream of an attribute is only started by the first face that uses it
+  AttributeFaces faces;
+  std::size_t num_positions = 0;
+  CompactFaces result;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef TYPES_FACE_SINK_HPP
+#define TYPES_FACE_SINK_HPP
+
+#include <array>
+
+#include <glm/glm.hpp>
+
+#include "Model.hpp"
+
+// Receives the triangular faces of a model one by one while it's being parsed, instead of them being stored in
+// Model::triangular_faces. This way a converter doesn't have to keep all the faces in memory
+class FaceSink {
+ public:
+  // model holds every attribute parsed so far, face is in the same format as the elements of
+  // Model::triangular_faces. Returns false if the face couldn't be used, which aborts parsing
+  virtual bool add_face(const Model& model, const std::array<glm::ivec3, 3>& face) = 0;
+
+  // Called after the last face was added
+  virtual bool finish() = 0;
+
+  virtual ~FaceSink() {}
+};
+
+#endif
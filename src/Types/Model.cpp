@@ -7,6 +7,13 @@ Model::Model(int approximate_size) {
   triangular_faces.reserve(approximate_size);
 }
 
+Model::Model(const ModelSize& size) {
+  positions.reserve(size.positions);
+  texture_coords.reserve(size.texture_coords);
+  normals.reserve(size.normals);
+  triangular_faces.reserve(size.triangular_faces);
+}
+
 namespace debug {
 std::ostream& operator<<(std::ostream& out, const glm::ivec3& vec) {
   out << vec.x << '/' << vec.y << '/' << vec.z;
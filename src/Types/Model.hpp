@@ -2,13 +2,30 @@
 #define TYPES_MODEL_REPR_HPP
 
 #include <array>
+#include <cstddef>
 #include <iostream>
 #include <vector>
 
 #include <glm/glm.hpp>
 
+// Number of elements of each attribute of a model, eg. to reserve the exact amount of memory before parsing one
+struct ModelSize {
+  std::size_t positions        = 0;
+  std::size_t texture_coords   = 0;
+  std::size_t normals          = 0;
+  std::size_t triangular_faces = 0;
+};
+
+// The attributes of a model that are needed besides the positions and the faces, which are always needed
+// Parsers can skip the others: their lines aren't read and the face indices pointing to them are -1
+struct ModelAttributes {
+  bool texture_coords = true;
+  bool normals        = true;
+};
+
 struct Model {
   explicit Model(int approximate_size = 50);
+  explicit Model(const ModelSize& size);
 
   // Position in homogenous coordinates. If no homogeneous coordinates are used, w = 1.0 is the default
   std::vector<glm::vec4> positions;
@@ -0,0 +1,36 @@
+#include "PositionArrays.hpp"
+
+#include <algorithm>
+
+PositionArrays::PositionArrays(const std::vector<glm::vec4>& positions)
+    : xs(positions.size()), ys(positions.size()), zs(positions.size()) {
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    xs[i] = positions[i].x;
+    ys[i] = positions[i].y;
+    zs[i] = positions[i].z;
+  }
+
+  const bool homogeneous = std::any_of(positions.begin(), positions.end(), [](const glm::vec4& position) {
+    return position.w != 1.0f;
+  });
+
+  if (homogeneous) {
+    ws.resize(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      ws[i] = positions[i].w;
+    }
+  }
+}
+
+void PositionArrays::store(std::vector<glm::vec4>& positions) const {
+  positions.resize(size());
+  for (std::size_t i = 0; i < size(); ++i) {
+    positions[i] = (*this)[i];
+  }
+}
+
+void PositionArrays::add_w() {
+  if (!has_w()) {
+    ws.assign(size(), 1.0f);
+  }
+}
@@ -0,0 +1,48 @@
+#ifndef TYPES_POSITION_ARRAYS_HPP
+#define TYPES_POSITION_ARRAYS_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "AlignedVector.hpp"
+
+// The positions of a model as a structure of arrays: x, y and z in separate aligned arrays, so the kernels working
+// on them load 4 or 8 coordinates at once instead of picking them out of vec4s. w has an array only if some position
+// has a w other than 1. Indices are the same as in Model::positions, so the faces of the model can be used with it
+class PositionArrays {
+ public:
+  PositionArrays() = default;
+  explicit PositionArrays(const std::vector<glm::vec4>& positions);
+
+  // Writes the positions back in the layout of Model::positions
+  void store(std::vector<glm::vec4>& positions) const;
+
+  std::size_t size() const { return xs.size(); }
+  bool has_w() const { return !ws.empty(); }
+
+  // Every position has a w of 1 without an array for it
+  void add_w();
+
+  glm::vec4 operator[](std::size_t i) const { return {xs[i], ys[i], zs[i], has_w() ? ws[i] : 1.0f}; }
+
+  float* x() { return xs.data(); }
+  float* y() { return ys.data(); }
+  float* z() { return zs.data(); }
+  // Only valid if has_w
+  float* w() { return ws.data(); }
+
+  const float* x() const { return xs.data(); }
+  const float* y() const { return ys.data(); }
+  const float* z() const { return zs.data(); }
+  const float* w() const { return ws.data(); }
+
+ private:
+  AlignedVector<float> xs;
+  AlignedVector<float> ys;
+  AlignedVector<float> zs;
+  AlignedVector<float> ws;
+};
+
+#endif
@@ -1,10 +1,17 @@
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "AsciiSTLPrinter.hpp"
 #include "Model.hpp"
 #include "ModelConverter.hpp"
 #include "ModelParser.hpp"
 #include "ObjParser.hpp"
+#include "ObjPrinter.hpp"
+#include "PLYParser.hpp"
+#include "PLYPrinter.hpp"
+#include "STLParser.hpp"
 #include "STLPrinter.hpp"
 
 namespace {
@@ -18,20 +25,104 @@ const std::string usage_text = R"(
     Example: ./model_converter ./cube.obj ../cube.stl
 
     This will read cube.obj and convert it to cube.stl, placing it into the parent directory
+
+    Options (can be anywhere in the argument list):
+      --stream    Write every triangle as soon as it's parsed, instead of keeping all faces in memory.
+                  Needs less memory, but the input is parsed on a single thread
+      --cache     Save the parsed model next to the input (as <input>.mcache), and load it from there on the
+                  next run if the input hasn't changed
+      --recompute-normals
+                  Write the facet normals computed from the triangle positions, instead of the normals of the
+                  input (the vn lines aren't even read). Facet normals are always written for triangles without
+                  normals
+      --ascii     Write ASCII STL instead of binary STL
+
+    If the output file name ends with .obj, the model is written as OBJ instead of STL (eg. to get rid of the
+    unsupported lines of the input, or to make all faces triangles). If it ends with .ply, the positions and the
+    triangles are written as binary PLY, which is about a third of the size of binary STL.
+    Input files ending with .ply are read as binary PLY instead of OBJ, and files ending with .stl as binary STL
+    (the corners with the same coordinates become shared vertices).
 )";
+
+bool ends_with(const std::string& text, const std::string& suffix) {
+  return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::unique_ptr<ModelParser> make_parser(const std::string& path) {
+  if (ends_with(path, ".ply")) {
+    return std::make_unique<PLYParser>();
+  }
+  if (ends_with(path, ".stl")) {
+    return std::make_unique<STLParser>();
+  }
+
+  return std::make_unique<ObjParser>();
 }
 
+std::unique_ptr<ModelPrinter> make_printer(const std::string& path, bool ascii, bool recompute_normals) {
+  if (ends_with(path, ".obj")) {
+    return std::make_unique<ObjPrinter>();
+  }
+  if (ends_with(path, ".ply")) {
+    return std::make_unique<PLYPrinter>();
+  }
+
+  if (ascii) {
+    auto printer = std::make_unique<AsciiSTLPrinter>();
+    printer->set_recompute_normals(recompute_normals);
+    return printer;
+  }
+
+  auto printer = std::make_unique<STLPrinter>();
+  printer->set_recompute_normals(recompute_normals);
+  return printer;
+}
+}  // namespace
+
 int main(int argc, const char* argv[]) {
-  if (argc < 2) {
+  std::vector<std::string> paths;
+  bool streaming         = false;
+  bool caching           = false;
+  bool recompute_normals = false;
+  bool ascii             = false;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string argument = argv[i];
+
+    if (argument == "--stream") {
+      streaming = true;
+    } else if (argument == "--cache") {
+      caching = true;
+    } else if (argument == "--recompute-normals") {
+      recompute_normals = true;
+    } else if (argument == "--ascii") {
+      ascii = true;
+    } else if (argument.compare(0, 2, "--") == 0) {
+      std::cerr << "Unknown option " << argument << "\n";
+      std::cerr << usage_text;
+      return -1;
+    } else {
+      paths.push_back(argument);
+    }
+  }
+
+  if (paths.empty()) {
     std::cerr << "Please provide an obj file to convert!\n";
     std::cerr << usage_text;
     return -1;
   }
 
-  const std::string file_path   = argv[1];
-  const std::string result_path = argc < 3 ? "./out.stl" : argv[2];
+  const std::string file_path   = paths[0];
+  const std::string result_path = paths.size() < 2 ? "./out.stl" : paths[1];
+
+  auto parser = make_parser(file_path);
+  parser->set_cache_enabled(caching);
+
+  ModelConverter converter{std::move(parser), make_printer(result_path, ascii, recompute_normals)};
+
+  if (streaming) {
+    return converter.convert_streaming(file_path, result_path) ? 0 : -1;
+  }
 
-  ModelConverter converter{std::make_unique<ObjParser>(), std::make_unique<STLPrinter>()};
-  converter.parse(file_path);
-  converter.print(result_path);
+  return converter.parse(file_path) && converter.print(result_path) ? 0 : -1;
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "catch/catch.hpp"
+
+#include "AsciiSTLPrinter.hpp"
+#include "FileHelper.hpp"
+
+TEST_CASE("ascii_triangle", "[AsciiSTLPrinter]") {
+  Model model{0};
+  model.positions = {{0, 0, 0, 1}, {2.5, 0, 0, 1}, {0, -0.1f, 1e-20f, 1}};
+  model.normals   = {{0, 1, 0}};
+  model.triangular_faces.push_back({glm::ivec3{0, -1, 0}, glm::ivec3{1, -1, 0}, glm::ivec3{2, -1, 0}});
+
+  AsciiSTLPrinter printer;
+  REQUIRE(printer.print(model, "ascii_test.stl"));
+  REQUIRE(read_file("ascii_test.stl") ==
+          "solid model\n"
+          "facet normal 0 1 0\n"
+          "outer loop\n"
+          "vertex 0 0 0\n"
+          "vertex 2.5 0 0\n"
+          "vertex 0 -0.1 1e-20\n"
+          "endloop\n"
+          "endfacet\n"
+          "endsolid model\n");
+
+  std::remove("ascii_test.stl");
+}
+
+TEST_CASE("ascii_parallel", "[AsciiSTLPrinter]") {
+  // More than one round of chunks, without normals so they are computed too
+  Model model{0};
+  for (int i = 0; i < 50000; ++i) {
+    model.positions.push_back({i / 7.0f, -i / 3.0f, 1.0f / (i + 1), 1});
+  }
+  for (int i = 0; i + 2 < 50000; ++i) {
+    model.triangular_faces.push_back({glm::ivec3{i, -1, -1}, glm::ivec3{i + 1, -1, -1}, glm::ivec3{i + 2, -1, -1}});
+  }
+
+  AsciiSTLPrinter printer;
+  printer.set_num_threads(1);
+  REQUIRE(printer.print(model, "ascii_serial.stl"));
+  printer.set_num_threads(3);
+  REQUIRE(printer.print(model, "ascii_parallel.stl"));
+
+  const std::string serial = read_file("ascii_serial.stl");
+  REQUIRE(read_file("ascii_parallel.stl") == serial);
+
+  // Every coordinate reads back to the same float
+  std::istringstream in{serial};
+  std::string word;
+  std::size_t vertices = 0;
+  while (in >> word) {
+    if (word == "vertex") {
+      const glm::vec4& position = model.positions[model.triangular_faces[vertices / 3][vertices % 3].x];
+      for (int i = 0; i < 3; ++i) {
+        in >> word;
+        REQUIRE(std::strtof(word.c_str(), nullptr) == position[i]);
+      }
+      ++vertices;
+    }
+  }
+  REQUIRE(vertices == 3 * model.triangular_faces.size());
+
+  std::remove("ascii_serial.stl");
+  std::remove("ascii_parallel.stl");
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "catch/catch.hpp"
+
+#include "BVH.hpp"
+#include "Computations.hpp"
+
+namespace {
+// Closed sphere of latitude x longitude quads
+Model generate_sphere(int latitude, int longitude) {
+  Model model{0};
+  for (int i = 0; i <= latitude; ++i) {
+    const float theta = 3.14159265f * i / latitude;
+    for (int j = 0; j < longitude; ++j) {
+      const float phi = 2 * 3.14159265f * j / longitude;
+      model.positions.push_back({std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta), 1});
+    }
+  }
+
+  const auto index = [&](int i, int j) { return glm::ivec3{i * longitude + j % longitude, -1, -1}; };
+  for (int i = 0; i < latitude; ++i) {
+    for (int j = 0; j < longitude; ++j) {
+      model.triangular_faces.push_back({index(i, j), index(i + 1, j), index(i + 1, j + 1)});
+      model.triangular_faces.push_back({index(i, j), index(i + 1, j + 1), index(i, j + 1)});
+    }
+  }
+
+  return model;
+}
+}  // namespace
+
+TEST_CASE("bvh_same_counts", "[BVH]") {
+  std::mt19937 generator{11};
+  std::uniform_real_distribution<float> coordinate{-1.5f, 1.5f};
+
+  const Model sphere = generate_sphere(150, 300);
+  const BVH bvh{sphere, 1};
+  REQUIRE(bvh.num_triangles() == sphere.triangular_faces.size());
+
+  for (int i = 0; i < 500; ++i) {
+    const glm::vec3 origin{coordinate(generator), coordinate(generator), coordinate(generator)};
+    const glm::vec3 direction{coordinate(generator), coordinate(generator), coordinate(generator)};
+
+    REQUIRE(num_of_intersections(origin, direction, bvh) == num_of_intersections(origin, direction, sphere));
+    REQUIRE(is_point_inside_model(origin, bvh) == is_point_inside_model(origin, sphere));
+  }
+
+  // Rays along the axes, parallel to many of the boxes
+  for (const glm::vec3 direction : {glm::vec3{1, 0, 0}, glm::vec3{0, -1, 0}, glm::vec3{0, 0, 1}}) {
+    for (int i = 0; i < 100; ++i) {
+      const glm::vec3 origin{coordinate(generator), coordinate(generator), coordinate(generator)};
+      REQUIRE(num_of_intersections(origin, direction, bvh) == num_of_intersections(origin, direction, sphere));
+    }
+  }
+
+  SECTION("same_tree_for_any_number_of_threads") {
+    const BVH parallel_bvh{sphere, 4};
+    REQUIRE(parallel_bvh.get_nodes().size() == bvh.get_nodes().size());
+
+    for (std::size_t i = 0; i < bvh.get_nodes().size(); ++i) {
+      REQUIRE(parallel_bvh.get_nodes()[i].index == bvh.get_nodes()[i].index);
+      REQUIRE(parallel_bvh.get_nodes()[i].count == bvh.get_nodes()[i].count);
+      REQUIRE(parallel_bvh.get_nodes()[i].min == bvh.get_nodes()[i].min);
+    }
+  }
+}
+
+TEST_CASE("bvh_bounded_depth", "[BVH]") {
+  // Triangles at exponentially growing distances in both directions along each axis: the splits only peel off the
+  // farthest few, so without the bound the tree would be 109 deep
+  Model model{0};
+  for (int axis = 0; axis < 3; ++axis) {
+    for (float distance = 1e-30f; distance < 1e12f; distance *= 1.5f) {
+      for (const float sign : {1.0f, -1.0f}) {
+        const int first = static_cast<int>(model.positions.size());
+        for (int corner = 0; corner < 3; ++corner) {
+          glm::vec4 position{0, 0, 0, 1};
+          position[axis] = sign * distance;
+          if (corner > 0) {
+            position[(axis + corner) % 3] += 1;
+          }
+          model.positions.push_back(position);
+        }
+        model.triangular_faces.push_back(
+            {glm::ivec3{first, -1, -1}, glm::ivec3{first + 1, -1, -1}, glm::ivec3{first + 2, -1, -1}});
+      }
+    }
+  }
+
+  const BVH bvh{model, 1};
+  const auto& nodes = bvh.get_nodes();
+  const std::function<std::size_t(std::size_t)> depth = [&](std::size_t node) -> std::size_t {
+    return nodes[node].is_leaf() ? 0 : 1 + std::max(depth(nodes[node].index), depth(nodes[node].index + 1));
+  };
+  REQUIRE(depth(0) == BVH::max_depth);
+
+  std::vector<glm::vec3> origins;
+  for (int i = 0; i < 20; ++i) {
+    origins.push_back({-1.0f, 0.01f + i * 0.04f, 0.2f});
+    origins.push_back({0.3f, -1.0f, 0.01f + i * 0.04f});
+  }
+  for (const glm::vec3 direction : {glm::vec3{1, 0, 0}, glm::vec3{0, 1000, 0.001f}, glm::vec3{-1, 0.1f, 0}}) {
+    std::vector<int> counts(origins.size());
+    bvh.num_of_intersections(origins.data(), origins.size(), direction, counts.data());
+
+    for (std::size_t i = 0; i < origins.size(); ++i) {
+      REQUIRE(num_of_intersections(origins[i], direction, bvh) == num_of_intersections(origins[i], direction, model));
+      REQUIRE(counts[i] == num_of_intersections(origins[i], direction, model));
+    }
+  }
+}
+
+TEST_CASE("bvh_edge_cases", "[BVH]") {
+  const BVH empty{Model{0}};
+  REQUIRE(num_of_intersections(glm::vec3{0}, glm::vec3{1}, empty) == 0);
+  REQUIRE(!is_point_inside_model(glm::vec3{0}, empty));
+
+  // Many triangles in the same place can't be split by their centroids
+  Model stacked{0};
+  stacked.positions = {{0, 0, 0, 1}, {1, 0, 0, 1}, {0, 1, 0, 1}};
+  for (int i = 0; i < 1001; ++i) {
+    stacked.triangular_faces.push_back({glm::ivec3{0, -1, -1}, glm::ivec3{1, -1, -1}, glm::ivec3{2, -1, -1}});
+  }
+  const BVH stacked_bvh{stacked};
+  REQUIRE(num_of_intersections(glm::vec3{0.2f, 0.2f, -1}, glm::vec3{0, 0, 1}, stacked_bvh) == 1001);
+  REQUIRE(num_of_intersections(glm::vec3{0.8f, 0.8f, -1}, glm::vec3{0, 0, 1}, stacked_bvh) == 0);
+}
+
+TEST_CASE("batch_inside_queries", "[BVH]") {
+  std::mt19937 generator{17};
+  std::uniform_real_distribution<float> coordinate{-1.2f, 1.2f};
+
+  const Model sphere = generate_sphere(40, 80);
+  const BVH bvh{sphere};
+
+  std::vector<glm::vec3> points(5000);
+  for (auto& point : points) {
+    point = {coordinate(generator), coordinate(generator), coordinate(generator)};
+  }
+
+  for (std::size_t num_threads : {1, 4}) {
+    const auto inside = are_points_inside_model(points.data(), points.size(), bvh, num_threads);
+    REQUIRE(inside.size() == points.size());
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      REQUIRE(static_cast<bool>(inside[i]) == is_point_inside_model(points[i], sphere));
+    }
+  }
+
+  REQUIRE(are_points_inside_model(points, sphere) == are_points_inside_model(points.data(), points.size(), bvh));
+  REQUIRE(are_points_inside_model(std::vector<glm::vec3>{}, sphere).empty());
+
+  // All points in one place
+  const std::vector<glm::vec3> same(10, glm::vec3{0.1f, 0.2f, 0.3f});
+  REQUIRE(are_points_inside_model(same, sphere) == std::vector<std::uint8_t>(10, 1));
+}
+
+TEST_CASE("packet_queries", "[BVH]") {
+  std::mt19937 generator{23};
+  std::uniform_real_distribution<float> coordinate{-1.2f, 1.2f};
+
+  const Model sphere = generate_sphere(30, 60);
+  const BVH bvh{sphere};
+
+  // A grid, whose rays run along edges and through vertices of the sphere, then scattered points, so packets diverge
+  std::vector<glm::vec3> origins;
+  for (int x = -5; x <= 5; ++x) {
+    for (int y = -5; y <= 5; ++y) {
+      for (int z = -5; z <= 5; ++z) {
+        origins.push_back(glm::vec3{x, y, z} * 0.2f);
+      }
+    }
+  }
+  for (int i = 0; i < 1000; ++i) {
+    origins.push_back({coordinate(generator), coordinate(generator), coordinate(generator)});
+  }
+
+  for (const glm::vec3& direction : {glm::vec3{1}, glm::vec3{0, 0, 1}, glm::vec3{-0.3f, 1, 0.2f}}) {
+    // Every length of the last packet
+    for (std::size_t count : {origins.size(), origins.size() - 1, std::size_t{5}, std::size_t{1}}) {
+      std::vector<int> counts(count, -1);
+      bvh.num_of_intersections(origins.data(), count, direction, counts.data());
+
+      for (std::size_t i = 0; i < count; ++i) {
+        REQUIRE(counts[i] == num_of_intersections(origins[i], direction, sphere));
+      }
+    }
+  }
+
+  int empty_count = -1;
+  BVH{}.num_of_intersections(origins.data(), 1, glm::vec3{1}, &empty_count);
+  REQUIRE(empty_count == 0);
+}
@@ -0,0 +1,124 @@
+#include <cstdio>
+#include <string>
+#include <variant>
+
+#include "catch/catch.hpp"
+
+#include "AsciiSTLPrinter.hpp"
+#include "CompactFaces.hpp"
+#include "Computations.hpp"
+#include "FileHelper.hpp"
+#include "PLYPrinter.hpp"
+#include "STLPrinter.hpp"
+
+namespace {
+// Strip of triangles over num_positions positions, only the positions are indexed
+Model generate_model(int num_positions) {
+  Model model{0};
+  for (int i = 0; i < num_positions; ++i) {
+    model.positions.push_back({i % 100 * 0.5f, i / 100 * 0.25f, (i % 7) * 0.1f, 1});
+  }
+  for (int i = 0; i + 2 < num_positions; ++i) {
+    model.triangular_faces.push_back({glm::ivec3{i, -1, -1}, glm::ivec3{i + 2, -1, -1}, glm::ivec3{i + 1, -1, -1}});
+  }
+  return model;
+}
+
+}  // namespace
+
+TEST_CASE("compact_face_alternatives", "[CompactFaces]") {
+  SECTION("16_bit_indices") {
+    const Model model        = generate_model(1000);
+    const CompactFaces faces = compact_faces(model);
+
+    REQUIRE(std::holds_alternative<PositionFaces<std::uint16_t>>(faces));
+    REQUIRE(num_faces(faces) == model.triangular_faces.size());
+    REQUIRE(memory_size(faces) == 6 * model.triangular_faces.size());
+    REQUIRE(expand_faces(faces) == model.triangular_faces);
+  }
+
+  SECTION("32_bit_indices") {
+    const Model model        = generate_model(70000);
+    const CompactFaces faces = compact_faces(model);
+
+    REQUIRE(std::holds_alternative<PositionFaces<std::uint32_t>>(faces));
+    // A third of the memory of Model::triangular_faces
+    REQUIRE(memory_size(faces) * 3 == model.triangular_faces.size() * sizeof(model.triangular_faces[0]));
+    REQUIRE(expand_faces(faces) == model.triangular_faces);
+  }
+
+  SECTION("attribute_streams") {
+    Model model                    = generate_model(100);
+    model.triangular_faces[5][1].z = 0;
+
+    const CompactFaces faces = compact_faces(model);
+    REQUIRE(std::holds_alternative<AttributeFaces>(faces));
+    REQUIRE(std::get<AttributeFaces>(faces).texture_coords.empty());
+    REQUIRE(std::get<AttributeFaces>(faces).normals.size() == model.triangular_faces.size());
+    REQUIRE(expand_faces(faces) == model.triangular_faces);
+  }
+}
+
+TEST_CASE("compact_face_sink", "[CompactFaces]") {
+  Model attribute_model                    = generate_model(100);
+  attribute_model.triangular_faces[5][1].z = 0;
+
+  for (const Model& model : {generate_model(1000), generate_model(70000), attribute_model}) {
+    CompactFaceSink sink;
+    for (const auto& face : model.triangular_faces) {
+      REQUIRE(sink.add_face(model, face));
+    }
+    REQUIRE(sink.finish());
+
+    const CompactFaces faces = sink.take_faces();
+    REQUIRE(faces.index() == compact_faces(model).index());
+    REQUIRE(memory_size(faces) == memory_size(compact_faces(model)));
+    REQUIRE(expand_faces(faces) == model.triangular_faces);
+  }
+}
+
+TEST_CASE("compact_face_loops", "[CompactFaces]") {
+  // Every alternative: 16 and 32 bit position indices, and a stream of normal indices
+  Model with_normals = generate_model(1000);
+  with_normals.normals.push_back({0, 0, 1});
+  with_normals.normals.push_back({0, 1, 0});
+  for (std::size_t i = 0; i < with_normals.triangular_faces.size(); i += 3) {
+    for (auto& vertex : with_normals.triangular_faces[i]) {
+      vertex.z = i % 2;
+    }
+  }
+
+  for (const Model& model : {generate_model(1000), generate_model(70000), with_normals}) {
+    const CompactFaces faces = compact_faces(model);
+
+    REQUIRE(surface_area(model, faces) == surface_area(model));
+
+    PLYPrinter printer;
+    REQUIRE(printer.print(model, "compact_faces_test.ply"));
+    const std::string expected = read_file("compact_faces_test.ply");
+    REQUIRE(printer.print_compact(model, faces, "compact_faces_test.ply"));
+    REQUIRE(read_file("compact_faces_test.ply") == expected);
+
+    // Written sequentially and by several threads into a mapping, with the stored and the recomputed normals
+    for (std::size_t num_threads : {1, 4}) {
+      for (bool recompute_normals : {false, true}) {
+        STLPrinter stl_printer;
+        stl_printer.set_num_threads(num_threads);
+        stl_printer.set_recompute_normals(recompute_normals);
+        REQUIRE(stl_printer.print(model, "compact_faces_test.stl"));
+        const std::string expected_stl = read_file("compact_faces_test.stl");
+        REQUIRE(stl_printer.print_compact(model, faces, "compact_faces_test.stl"));
+        REQUIRE(read_file("compact_faces_test.stl") == expected_stl);
+      }
+    }
+
+    AsciiSTLPrinter ascii_printer;
+    REQUIRE(ascii_printer.print(model, "compact_faces_test.stl"));
+    const std::string expected_ascii = read_file("compact_faces_test.stl");
+    REQUIRE(ascii_printer.print_compact(model, faces, "compact_faces_test.stl"));
+    REQUIRE(read_file("compact_faces_test.stl") == expected_ascii);
+  }
+
+  std::remove("compact_faces_test.ply");
+  std::remove("compact_faces_test.stl");
+}
@@ -1,3 +1,7 @@
+#include <cmath>
+#include <cstdint>
+#include <random>
+
 #include "catch/catch.hpp"
 
 // GLM needs an extra define to enable transformations
@@ -147,3 +151,117 @@ TEST_CASE("transformations", "[transformations]") {
     REQUIRE(vec_almost_equal(model.positions[1], glm::vec4{8, 0, 2, 1}));
   }
 }
+
+TEST_CASE("position_arrays", "[PositionArrays]") {
+  std::mt19937 generator{3};
+  std::uniform_real_distribution<float> coordinate{-1, 1};
+  std::uniform_int_distribution<int> index{0, 999};
+
+  // Random triangles, so the rays hit some of them and miss others
+  Model model{0};
+  for (int i = 0; i < 1000; ++i) {
+    model.positions.push_back({coordinate(generator), coordinate(generator), coordinate(generator), 1});
+  }
+  for (int i = 0; i < 3000; ++i) {
+    model.triangular_faces.push_back({glm::ivec3{index(generator), -1, -1},
+                                      glm::ivec3{index(generator), -1, -1},
+                                      glm::ivec3{index(generator), -1, -1}});
+  }
+
+  PositionArrays positions{model.positions};
+  REQUIRE(positions.size() == model.positions.size());
+  REQUIRE(!positions.has_w());
+  REQUIRE(reinterpret_cast<std::uintptr_t>(positions.x()) % 64 == 0);
+
+  std::vector<glm::vec4> stored;
+  positions.store(stored);
+  REQUIRE(stored == model.positions);
+
+  SECTION("same_results") {
+    REQUIRE(surface_area(model, positions) == surface_area(model));
+
+    for (int i = 0; i < 200; ++i) {
+      const glm::vec3 origin{coordinate(generator), coordinate(generator), coordinate(generator)};
+      const glm::vec3 direction{coordinate(generator), coordinate(generator), coordinate(generator)};
+      REQUIRE(num_of_intersections(origin, direction, model, positions) ==
+              num_of_intersections(origin, direction, model));
+      REQUIRE(is_point_inside_model(origin, model, positions) == is_point_inside_model(origin, model));
+    }
+  }
+
+  SECTION("transform") {
+    const glm::mat4 transformation = glm::rotate(0.3f, glm::vec3{1, 2, 3}) * glm::translate(glm::vec3{1, -4, 2});
+    transform(positions, transformation);
+    transform(model, transformation);
+
+    REQUIRE(!positions.has_w());
+    for (std::size_t i = 0; i < model.positions.size(); ++i) {
+      REQUIRE(vec_almost_equal(positions[i], model.positions[i]));
+    }
+  }
+
+  SECTION("homogeneous") {
+    model.positions[7].w = 0.5;
+    PositionArrays homogeneous{model.positions};
+    REQUIRE(homogeneous.has_w());
+    REQUIRE(homogeneous[7] == model.positions[7]);
+
+    // A projective transformation needs w for every position
+    glm::mat4 projection{1};
+    projection[2][3] = 1;
+    transform(positions, projection);
+    REQUIRE(positions.has_w());
+    REQUIRE(positions[0].w == model.positions[0].z + 1);
+  }
+}
+
+TEST_CASE("parallel_surface_area", "[surface_area]") {
+  std::mt19937 generator{9};
+  std::uniform_real_distribution<float> coordinate{-1, 1};
+  std::uniform_int_distribution<int> index{0, 999};
+
+  // Several tasks and a partial last block
+  Model model{0};
+  for (int i = 0; i < 1000; ++i) {
+    model.positions.push_back({coordinate(generator), coordinate(generator), coordinate(generator), 1});
+  }
+  for (int i = 0; i < 100003; ++i) {
+    model.triangular_faces.push_back({glm::ivec3{index(generator), -1, -1},
+                                      glm::ivec3{index(generator), -1, -1},
+                                      glm::ivec3{index(generator), -1, -1}});
+  }
+
+  // Areas of the triangles summed in long double, one after the other
+  long double expected = 0;
+  for (const auto& face : model.triangular_faces) {
+    expected += area_of_triangle({glm::vec3{model.positions[face[0].x]},
+                                  glm::vec3{model.positions[face[1].x]},
+                                  glm::vec3{model.positions[face[2].x]}});
+  }
+
+  const double area = parallel_surface_area(model, 1);
+  REQUIRE(std::abs(area - static_cast<double>(expected)) < 1e-12 * area);
+  for (std::size_t num_threads : {2, 3, 8, 0}) {
+    REQUIRE(parallel_surface_area(model, num_threads) == area);
+  }
+
+  // Grid of 1000 x 1000 squares with a side of 1/1024, every area is exact
+  Model grid{0};
+  for (int x = 0; x <= 1000; ++x) {
+    for (int y = 0; y <= 1000; ++y) {
+      grid.positions.push_back({x / 1024.0f, y / 1024.0f, 0, 1});
+    }
+  }
+  for (int x = 0; x < 1000; ++x) {
+    for (int y = 0; y < 1000; ++y) {
+      const int corner = x * 1001 + y;
+      grid.triangular_faces.push_back(
+          {glm::ivec3{corner, -1, -1}, glm::ivec3{corner + 1001, -1, -1}, glm::ivec3{corner + 1002, -1, -1}});
+      grid.triangular_faces.push_back(
+          {glm::ivec3{corner, -1, -1}, glm::ivec3{corner + 1002, -1, -1}, glm::ivec3{corner + 1, -1, -1}});
+    }
+  }
+  REQUIRE(parallel_surface_area(grid) == (1000.0 / 1024) * (1000.0 / 1024));
+
+  REQUIRE(parallel_surface_area(Model{0}) == 0);
+}
@@ -0,0 +1,48 @@
+#include <random>
+
+#include "catch/catch.hpp"
+
+#include "AssertionHelper.hpp"
+#include "FaceNormals.hpp"
+
+TEST_CASE("face_normal", "[FaceNormals]") {
+  REQUIRE(vec_almost_equal(face_normal({0, 0, 0}, {2, 0, 0}, {0, 2, 0}), glm::vec3{0, 0, 1}));
+  REQUIRE(vec_almost_equal(face_normal({0, 0, 0}, {0, 2, 0}, {2, 0, 0}), glm::vec3{0, 0, -1}));
+  REQUIRE(vec_almost_equal(face_normal({1, 1, 1}, {1, 1, 3}, {1, 5, 1}), glm::vec3{-1, 0, 0}));
+
+  // Degenerate triangles have no normal
+  REQUIRE(face_normal({1, 1, 1}, {1, 1, 1}, {2, 2, 2}) == glm::vec3{0});
+  REQUIRE(face_normal({0, 0, 0}, {1, 1, 1}, {2, 2, 2}) == glm::vec3{0});
+}
+
+TEST_CASE("engine_levels", "[FaceNormals]") {
+  // Odd number of triangles with a few degenerate ones, so the SIMD tails and masks are covered too
+  std::mt19937 generator{7};
+  std::uniform_real_distribution<float> coordinate{-10.0f, 10.0f};
+
+  Model model{0};
+  for (int i = 0; i < 3000; ++i) {
+    model.positions.push_back({coordinate(generator), coordinate(generator), coordinate(generator), 1});
+  }
+  for (int i = 0; i + 2 < 3000; ++i) {
+    const int repeated = i % 17 == 0 ? i : i + 1;
+    model.triangular_faces.push_back({glm::ivec3{i, -1, -1}, glm::ivec3{repeated, -1, -1}, glm::ivec3{i + 2, -1, -1}});
+  }
+
+  for (auto level : {FaceNormalEngine::Level::scalar, FaceNormalEngine::Level::sse2, FaceNormalEngine::Level::avx2}) {
+    const FaceNormalEngine engine{level};
+    const auto normals = engine.compute(model, 3);
+
+    REQUIRE(normals.size() == model.triangular_faces.size());
+    for (std::size_t i = 0; i < normals.size(); ++i) {
+      REQUIRE(vec_almost_equal(normals[i], face_normal(model, model.triangular_faces[i])));
+    }
+
+    // Any range of faces can be computed on its own
+    std::vector<glm::vec3> range(13);
+    engine.compute(model, 1001, range.size(), range.data());
+    for (std::size_t i = 0; i < range.size(); ++i) {
+      REQUIRE(vec_almost_equal(range[i], normals[1001 + i]));
+    }
+  }
+}
@@ -0,0 +1,20 @@
+#ifndef TESTS_FILE_HELPER_HPP
+#define TESTS_FILE_HELPER_HPP
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+// The whole file as bytes, empty if it can't be read
+inline std::string read_file(const std::string& path) {
+  std::ifstream in{path, std::ios::binary};
+  return std::string{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+// Appends the bytes of value, for building binary files in memory
+template <class Scalar>
+void append_binary(std::string& data, Scalar value) {
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "catch/catch.hpp"
+
+#include "FileHelper.hpp"
+#include "FileWriter.hpp"
+
+TEST_CASE("file_writer", "[FileWriter]") {
+  const std::string path = "file_writer_test.bin";
+
+  auto writer = FileWriter::open(path);
+  REQUIRE(writer);
+
+  SECTION("appends_in_order") {
+    std::string expected;
+    // Enough small pieces to fill the buffer a few times, so the flushes in the middle are covered too
+    for (std::size_t i = 0; expected.size() < 3 * FileWriter::buffer_size; ++i) {
+      const std::string piece = std::to_string(i) + ",";
+      if (i % 2 == 0) {
+        writer->append(piece.data(), piece.size());
+      } else {
+        std::memcpy(writer->append(piece.size()), piece.data(), piece.size());
+      }
+      expected += piece;
+    }
+
+    const std::string large(FileWriter::buffer_size + 5, 'x');
+    writer->append(large.data(), large.size());
+    expected += large;
+
+    REQUIRE(writer->close());
+    REQUIRE(read_file(path) == expected);
+  }
+
+  SECTION("write_at") {
+    writer->append("0000 tail");
+    REQUIRE(writer->write_at(1, "12", 2));
+    writer->append("!");
+
+    REQUIRE(writer->close());
+    REQUIRE(read_file(path) == "0120 tail!");
+  }
+
+  SECTION("moved") {
+    FileWriter moved = std::move(*writer);
+    moved.append("abc");
+    writer.reset();
+
+    REQUIRE(moved.close());
+    REQUIRE(read_file(path) == "abc");
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("file_writer_open_fails", "[FileWriter]") {
+  REQUIRE(!FileWriter::open("asda/sfag/sdgsdfgmi/songuaio/sffnggsdu/nggsandgai/ksundgi/sandgdsa.bin"));
+}
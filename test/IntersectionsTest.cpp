@@ -0,0 +1,113 @@
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "catch/catch.hpp"
+
+#include "Computations.hpp"
+#include "Intersections.hpp"
+
+namespace {
+// Triangles as the engine takes them, padded
+struct Triangles {
+  std::vector<std::array<glm::vec3, 3>> corners;
+  std::vector<float> arrays[9];
+
+  void add(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) { corners.push_back({a, b, c}); }
+
+  IntersectionEngine::TriangleArrays get_arrays() {
+    for (auto& array : arrays) {
+      array.assign(corners.size() + IntersectionEngine::padding, 0);
+    }
+    for (std::size_t i = 0; i < corners.size(); ++i) {
+      const glm::vec3 e1 = corners[i][1] - corners[i][0];
+      const glm::vec3 e2 = corners[i][2] - corners[i][0];
+      for (int axis = 0; axis < 3; ++axis) {
+        arrays[axis][i]     = corners[i][0][axis];
+        arrays[3 + axis][i] = e1[axis];
+        arrays[6 + axis][i] = e2[axis];
+      }
+    }
+    return {{arrays[0].data(), arrays[1].data(), arrays[2].data()},
+            {arrays[3].data(), arrays[4].data(), arrays[5].data()},
+            {arrays[6].data(), arrays[7].data(), arrays[8].data()}};
+  }
+
+  int expected(const glm::vec3& origin, const glm::vec3& direction, std::size_t first, std::size_t count) const {
+    int hits = 0;
+    glm::vec3 point;
+    for (std::size_t i = first; i < first + count; ++i) {
+      hits += RayIntersectsTriangle(origin, direction, corners[i], point);
+    }
+    return hits;
+  }
+};
+
+IntersectionEngine::TriangleArrays offset(const IntersectionEngine::TriangleArrays& arrays, std::size_t first) {
+  const auto at = [&](const std::array<const float*, 3>& array) {
+    return std::array<const float*, 3>{array[0] + first, array[1] + first, array[2] + first};
+  };
+  return {at(arrays.v0), at(arrays.e1), at(arrays.e2)};
+}
+}  // namespace
+
+TEST_CASE("intersection_engine_levels", "[Intersections]") {
+  std::mt19937 generator{11};
+  std::uniform_real_distribution<float> coordinate{-2.0f, 2.0f};
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float inf = std::numeric_limits<float>::infinity();
+
+  Triangles triangles;
+  for (int i = 0; i < 1000; ++i) {
+    triangles.add({coordinate(generator), coordinate(generator), coordinate(generator)},
+                  {coordinate(generator), coordinate(generator), coordinate(generator)},
+                  {coordinate(generator), coordinate(generator), coordinate(generator)});
+  }
+  // Grid of triangles, so rays through its vertices and along its edges hit the borders of several triangles
+  for (int x = -2; x < 2; ++x) {
+    for (int y = -2; y < 2; ++y) {
+      const glm::vec3 corner{x, y, 0.5f};
+      triangles.add(corner, corner + glm::vec3{1, 0, 0}, corner + glm::vec3{0, 1, 0});
+      triangles.add(corner + glm::vec3{1, 1, 0}, corner + glm::vec3{0, 1, 0}, corner + glm::vec3{1, 0, 0});
+    }
+  }
+  // Degenerate, parallel to the rays of glm::vec3{1}, tiny, huge and non-finite triangles
+  triangles.add({0, 0, 0}, {1, 1, 1}, {2, 2, 2});
+  triangles.add({0, 0, 0}, {0, 0, 0}, {0, 0, 0});
+  triangles.add({1, 0, 0}, {0, 1, 0}, {2, 1, 1});
+  triangles.add({0.5f, 0.5f, 0.5f}, {0.5f + 1e-4f, 0.5f, 0.5f}, {0.5f, 0.5f + 1e-4f, 0.5f});
+  triangles.add({-1e30f, -1e30f, 3}, {1e30f, 0, 3}, {0, 1e30f, 3});
+  triangles.add({nan, 0, 0}, {1, 0, 0}, {0, 1, 0});
+  triangles.add({inf, 0, 0}, {1, 0, 0}, {0, 1, 0});
+  triangles.add({0, 0, -inf}, {1, 0, 0}, {0, 1, 0});
+
+  const auto arrays = triangles.get_arrays();
+  const std::size_t size = triangles.corners.size();
+
+  std::vector<std::pair<glm::vec3, glm::vec3>> rays = {
+      {{0, 0, 0}, {1, 1, 1}},       {{-1, -1, -1}, {1, 1, 1}}, {{0, 0, -1}, {0, 0, 1}},   {{1, 1, -1}, {0, 0, 1}},
+      {{0.5f, 0, -1}, {0, 0, 1}},   {{0, 0, -1}, {1, 0, 0}},   {{0, 0, 5}, {0, 0, -1}},   {{0, 0, 0}, {0, 0, 0}},
+      {{nan, 0, 0}, {1, 1, 1}},     {{0, 0, 0}, {inf, 1, 1}},  {{0.5f, 0.5f, 0.5f}, {1, 1, 1}},
+  };
+  for (int i = 0; i < 200; ++i) {
+    rays.push_back({{coordinate(generator), coordinate(generator), coordinate(generator)},
+                    {coordinate(generator), coordinate(generator), coordinate(generator)}});
+  }
+
+  for (auto level : {IntersectionEngine::Level::scalar, IntersectionEngine::Level::sse2,
+                     IntersectionEngine::Level::avx2}) {
+    const IntersectionEngine engine{level};
+
+    for (const auto& [origin, direction] : rays) {
+      REQUIRE(engine.count(origin, direction, arrays, size) == triangles.expected(origin, direction, 0, size));
+
+      // Ranges of any length at any offset, so every tail and alignment is covered
+      for (std::size_t first : {0, 1, 3, 997, 1000}) {
+        for (std::size_t count = 0; count <= 17 && first + count <= size; ++count) {
+          REQUIRE(engine.count(origin, direction, offset(arrays, first), count) ==
+                  triangles.expected(origin, direction, first, count));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "catch/catch.hpp"
+
+#include "FileHelper.hpp"
+#include "ModelCache.hpp"
+#include "ObjParser.hpp"
+#include "Parallel.hpp"
+
+namespace {
+void require_same_model(const Model& lhs, const Model& rhs) {
+  REQUIRE(lhs.positions == rhs.positions);
+  REQUIRE(lhs.texture_coords == rhs.texture_coords);
+  REQUIRE(lhs.normals == rhs.normals);
+  REQUIRE(lhs.triangular_faces == rhs.triangular_faces);
+}
+
+// Exposes the variant the parser stores its caches with
+class VariantObjParser : public ObjParser {
+ public:
+  using ObjParser::cache_variant;
+};
+}  // namespace
+
+TEST_CASE("hash_bytes", "[ModelCache]") {
+  const std::string text = "v 1 2 3\nv 4 5 6\nvn 0 0 1\nf 1//1 2//1 3//1\n";
+
+  REQUIRE(hash_bytes(text) == hash_bytes(std::string{text}));
+  REQUIRE(hash_bytes("") != hash_bytes(std::string(1, '\0')));
+
+  // Every byte, in the 32 byte blocks and in the tail, changes the hash
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    std::string changed = text;
+    changed[i] ^= 1;
+    REQUIRE(hash_bytes(changed) != hash_bytes(text));
+  }
+}
+
+TEST_CASE("save_and_load", "[ModelCache]") {
+  const std::string cache_path = "cache_test.mcache";
+
+  Model model{0};
+  model.positions      = {{0, 0, 0, 1}, {1, 0, 0, 1}, {1, 1, 0, 0.5}};
+  model.texture_coords = {{0.5, 0.25, 0}};
+  model.normals        = {{0, 0, 1}, {0, 1, 0}};
+  model.triangular_faces.push_back({glm::ivec3{0, 0, 0}, glm::ivec3{1, -1, 1}, glm::ivec3{2, -1, -1}});
+
+  const ModelCacheKey key{1234, 5678, 91011, 0};
+  REQUIRE(save_model_cache(model, cache_path, key));
+
+  SECTION("same_key") {
+    const auto loaded = load_model_cache(cache_path, key);
+    REQUIRE(loaded);
+    require_same_model(*loaded, model);
+  }
+
+  SECTION("different_key") {
+    for (auto other = key; other.source_size++ == key.source_size;) {
+      REQUIRE(!load_model_cache(cache_path, other));
+    }
+    for (auto other = key; other.source_mtime_ns++ == key.source_mtime_ns;) {
+      REQUIRE(!load_model_cache(cache_path, other));
+    }
+    for (auto other = key; other.source_hash++ == key.source_hash;) {
+      REQUIRE(!load_model_cache(cache_path, other));
+    }
+    for (auto other = key; other.parser_variant++ == key.parser_variant;) {
+      REQUIRE(!load_model_cache(cache_path, other));
+    }
+  }
+
+  SECTION("truncated") {
+    std::string contents = read_file(cache_path);
+
+    contents.pop_back();
+    std::ofstream{cache_path, std::ios::binary} << contents;
+
+    REQUIRE(!load_model_cache(cache_path, key));
+  }
+
+  SECTION("concurrent_saves") {
+    // Every writer has its own temporary file, so the cache ends up as one of the complete models
+    std::vector<Model> models(8, model);
+    for (std::size_t i = 0; i < models.size(); ++i) {
+      models[i].positions.resize(1000 * (i + 1), {static_cast<float>(i), 0, 0, 1});
+    }
+
+    std::vector<char> saved(models.size());
+    parallel_for(models.size(), models.size(), [&](std::size_t i) {
+      saved[i] = save_model_cache(models[i], cache_path, key);
+    });
+    REQUIRE(std::count(saved.begin(), saved.end(), true) == static_cast<long>(models.size()));
+
+    const auto loaded = load_model_cache(cache_path, key);
+    REQUIRE(loaded);
+    const std::size_t i = loaded->positions.size() / 1000 - 1;
+    REQUIRE(i < models.size());
+    require_same_model(*loaded, models[i]);
+  }
+
+  SECTION("missing") {
+    std::remove(cache_path.c_str());
+    REQUIRE(!load_model_cache(cache_path, key));
+  }
+
+  std::remove(cache_path.c_str());
+}
+
+TEST_CASE("parser_cache", "[ModelCache]") {
+  const std::string obj_path   = "cache_test.obj";
+  const std::string cache_path = model_cache_path(obj_path);
+  std::ofstream{obj_path} << "v 0 0 0\nv 1 0 0\nv 1 1 0\nvn 0 0 1\nf 1//1 2//1 3//1\n";
+
+  VariantObjParser parser;
+  parser.set_cache_enabled(true);
+
+  const auto parsed = parser.parse(obj_path);
+  REQUIRE(parsed);
+  REQUIRE(std::ifstream{cache_path}.good());
+
+  SECTION("loaded_from_cache") {
+    REQUIRE(parser.parse(obj_path)->triangular_faces == parsed->triangular_faces);
+
+    // Replace the cached model under the same key: a model that comes back must have been loaded from the cache
+    const auto key = make_model_cache_key(obj_path, "v 0 0 0\nv 1 0 0\nv 1 1 0\nvn 0 0 1\nf 1//1 2//1 3//1\n",
+                                          parser.cache_variant());
+    REQUIRE(key);
+
+    Model other{0};
+    other.positions = {{5, 5, 5, 1}};
+    REQUIRE(save_model_cache(other, cache_path, *key));
+
+    const auto cached = parser.parse(obj_path);
+    REQUIRE(cached);
+    require_same_model(*cached, other);
+  }
+
+  SECTION("other_attributes") {
+    parser.set_required_attributes({false, false});
+
+    const auto reparsed = parser.parse(obj_path);
+    REQUIRE(reparsed);
+    REQUIRE(reparsed->normals.empty());
+  }
+
+  SECTION("source_changed") {
+    std::ofstream{obj_path, std::ios::app} << "v 0 1 0\nf 1 3 4\n";
+
+    const auto reparsed = parser.parse(obj_path);
+    REQUIRE(reparsed);
+    REQUIRE(reparsed->positions.size() == 4);
+    REQUIRE(reparsed->triangular_faces.size() == 2);
+  }
+
+  std::remove(obj_path.c_str());
+  std::remove(cache_path.c_str());
+}
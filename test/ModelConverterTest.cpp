@@ -1,7 +1,17 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <variant>
+
 #include "catch/catch.hpp"
 
+#include "FileHelper.hpp"
 #include "ModelConverter.hpp"
 #include "ObjParser.hpp"
+#include "ObjPrinter.hpp"
+#include "PLYParser.hpp"
+#include "PLYPrinter.hpp"
 #include "STLPrinter.hpp"
 
 TEST_CASE("parser", "[ModelConverter]") {
@@ -33,4 +43,81 @@ TEST_CASE("printer", "[ModelConverter]") {
     converter.set_printer(nullptr);
     REQUIRE(!converter.print("a.stl"));
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("streaming", "[ModelConverter]") {
+  const std::string obj_path = "streaming_test.obj";
+  std::ofstream{obj_path} << R"(v 0 0 0
+v 1 0 0
+v 1 1 0
+vn 0 0 1
+f 1//1 2//1 3//1
+v 0 1 0
+f 1//1 3//1 -1//1
+f 1 2 3 4
+)";
+
+  ModelConverter converter{std::make_unique<ObjParser>(), std::make_unique<STLPrinter>()};
+
+  SECTION("same_output_as_parse_and_print") {
+    REQUIRE(converter.parse(obj_path));
+    REQUIRE(converter.print("streaming_test_expected.stl"));
+    REQUIRE(converter.convert_streaming(obj_path, "streaming_test.stl"));
+
+    const std::string stl = read_file("streaming_test.stl");
+    REQUIRE(stl.size() == 84 + 4 * 50);
+    REQUIRE(stl == read_file("streaming_test_expected.stl"));
+
+    // Only the attributes are kept
+    REQUIRE(converter.get_model()->positions.size() == 4);
+    REQUIRE(converter.get_model()->triangular_faces.empty());
+  }
+
+  SECTION("compact_faces_until_printed") {
+    REQUIRE(converter.parse(obj_path));
+    REQUIRE(converter.get_model()->triangular_faces.empty());
+    REQUIRE(converter.get_compact_faces());
+    REQUIRE(num_faces(*converter.get_compact_faces()) == 4);
+
+    // The OBJ printer would have to expand them again
+    converter.set_printer(std::make_unique<ObjPrinter>());
+    REQUIRE(converter.parse(obj_path));
+    REQUIRE(converter.get_model()->triangular_faces.size() == 4);
+    REQUIRE(!converter.get_compact_faces());
+  }
+
+  SECTION("compact_faces_while_parsing") {
+    REQUIRE(converter.parse(obj_path));
+    REQUIRE(converter.print("streaming_test_expected.stl"));
+
+    converter.set_printer(std::make_unique<PLYPrinter>());
+    REQUIRE(converter.parse(obj_path));
+    REQUIRE(converter.print("streaming_test.ply"));
+
+    // The PLY parser passes the faces to the compact face sink as it reads them
+    converter.set_parser(std::make_unique<PLYParser>());
+    converter.set_printer(std::make_unique<STLPrinter>());
+    REQUIRE(converter.parse("streaming_test.ply"));
+    REQUIRE(converter.get_model()->triangular_faces.empty());
+    REQUIRE(std::holds_alternative<PositionFaces<std::uint16_t>>(*converter.get_compact_faces()));
+    REQUIRE(converter.print("streaming_test.stl"));
+
+    // PLY has no normals, so only the corners are compared
+    const std::string stl      = read_file("streaming_test.stl");
+    const std::string expected = read_file("streaming_test_expected.stl");
+    REQUIRE(stl.size() == expected.size());
+    for (std::size_t triangle = 0; triangle < 4; ++triangle) {
+      REQUIRE(stl.compare(84 + triangle * 50 + 12, 38, expected, 84 + triangle * 50 + 12, 38) == 0);
+    }
+    std::remove("streaming_test.ply");
+  }
+
+  SECTION("normal_defined_after_face") {
+    std::ofstream{obj_path, std::ios::app} << "f 1//2 2//2 3//2\nvn 1 0 0\n";
+    REQUIRE(!converter.convert_streaming(obj_path, "streaming_test.stl"));
+  }
+
+  std::remove(obj_path.c_str());
+  std::remove("streaming_test.stl");
+  std::remove("streaming_test_expected.stl");
+}
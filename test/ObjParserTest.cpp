@@ -1,6 +1,7 @@
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <sstream>
@@ -16,12 +17,25 @@ class ObjParserTest {
  public:
   ObjParserTest() : obj_parser{std::make_unique<ObjParser>()} {}
 
+  void set_required_attributes(const ModelAttributes& attributes) { obj_parser->set_required_attributes(attributes); }
+
   std::optional<Model> parse_file(std::istream& in) { return obj_parser->parse_file(in); }
 
+  std::optional<Model> parse_buffer(std::string_view data) { return obj_parser->parse_buffer(data); }
+
+  std::optional<Model> parse_chunks(std::string_view data, std::size_t num_chunks) {
+    return obj_parser->parse_chunks(data, num_chunks);
+  }
+
   bool process_line(std::string&& line, Model& model) { return obj_parser->process_line(std::move(line), model); }
 
   std::optional<std::vector<glm::ivec3>> process_faces(const std::string_view& faces_string) {
-    return obj_parser->process_faces(faces_string);
+    std::vector<glm::ivec3> faces;
+    if (!obj_parser->process_faces(faces_string, faces)) {
+      return std::nullopt;
+    }
+
+    return faces;
   }
 
  private:
@@ -47,6 +61,15 @@ TEST_CASE("process_line", "[process_line]") {
     REQUIRE(vec_almost_equal(model.positions[0], glm::vec4(-5, 5, 0, 2.5)));
   }
 
+  SECTION("Correct_position_out_of_float_range") {
+    success = test.process_line("v 1e-50 1e39 -1e39", model);
+    REQUIRE(success);
+    REQUIRE(model.positions.size() == 1);
+    REQUIRE(model.positions[0].x == 0.0f);
+    REQUIRE(model.positions[0].y == std::numeric_limits<float>::infinity());
+    REQUIRE(model.positions[0].z == -std::numeric_limits<float>::infinity());
+  }
+
   SECTION("Correct_texture") {
     success = test.process_line("vt     -5.000000      -5.000000       0.000000", model);
     REQUIRE(success);
@@ -81,6 +104,15 @@ TEST_CASE("process_line", "[process_line]") {
             std::array<glm::ivec3, 3>{glm::ivec3{0, 0, 0}, glm::ivec3{3, 3, 3}, glm::ivec3{22, 8988, 77}});
   }
 
+  SECTION("only_labels") {
+    for (const auto* line : {"v", "vt", "vn", "f"}) {
+      REQUIRE_NOTHROW(success = test.process_line(line, model));
+      REQUIRE(!success);
+    }
+    REQUIRE(model.positions.empty());
+    REQUIRE(model.triangular_faces.empty());
+  }
+
   SECTION("faces_negative_numbers") {
     model.positions.emplace_back(13, 1, 1, 3);  // position 1
     model.positions.emplace_back(1, 12, 1, 3);  // position 2
@@ -131,6 +163,211 @@ f 1/1/1 2/2/2 3/4/6
   }
 }
 
+TEST_CASE("buffer_matches_stream", "[parse_buffer]") {
+  ObjParserTest test;
+  const std::string file_contents =
+      R"(v 12.0 11.23 32.42
+vt 0.23 0.34
+
+vn 1.01 2.12 0.12
+# comment
+v 1.12 1.233 12.76
+v 1.0 2.0 3.0
+f 1/1/1 2/1/1 -1/1/1)";
+
+  std::istringstream input_stream{file_contents};
+  auto from_stream = test.parse_file(input_stream);
+  auto from_buffer = test.parse_buffer(file_contents);
+
+  REQUIRE(from_stream);
+  REQUIRE(from_buffer);
+  REQUIRE(from_buffer->positions.size() == 3);
+  REQUIRE(from_buffer->triangular_faces.size() == 1);
+  REQUIRE(from_buffer->triangular_faces == from_stream->triangular_faces);
+  REQUIRE(vec_almost_equal(from_buffer->positions[1], from_stream->positions[1]));
+
+  SECTION("empty_buffer") {
+    auto result = test.parse_buffer("");
+    REQUIRE(result);
+    REQUIRE(result->positions.empty());
+  }
+
+  SECTION("error_in_buffer") { REQUIRE(!test.parse_buffer("v 1.0 2.0 3.0\nv 1.0 asd\n")); }
+
+  SECTION("face_without_vertices") {
+    std::optional<Model> result;
+    REQUIRE_NOTHROW(result = test.parse_buffer("v 0 0 0\nv 1 0 0\nv 0 1 0\nf\n"));
+    REQUIRE(!result);
+  }
+}
+
+TEST_CASE("chunks_match_serial", "[parse_chunks]") {
+  ObjParserTest test;
+
+  // Relative indices that point back into earlier chunks, mixed with absolute ones
+  std::string file_contents;
+  for (int i = 0; i < 200; ++i) {
+    const std::string n = std::to_string(i);
+    file_contents += "v " + n + ".5 1.0 -" + n + "\n";
+    file_contents += "vt 0." + n + " 0.5\n";
+    if (i % 3 == 0) {
+      file_contents += "vn 0.0 1.0 0." + n + "\n";
+    }
+    if (i >= 3) {
+      file_contents += "f -1/-1/-1 -2/-2/-1 -3/3/1 " + std::to_string(i) + "/1/-1\n";
+      file_contents += "f 1/-1/1 -2/1/1 -3/-3/-1\n";
+    }
+  }
+
+  std::istringstream input_stream{file_contents};
+  const auto serial = test.parse_file(input_stream);
+  REQUIRE(serial);
+
+  for (std::size_t num_chunks : {1, 2, 3, 7, 64}) {
+    const auto parallel = test.parse_chunks(file_contents, num_chunks);
+
+    REQUIRE(parallel);
+    REQUIRE(parallel->triangular_faces == serial->triangular_faces);
+    REQUIRE(parallel->positions.size() == serial->positions.size());
+    REQUIRE(parallel->texture_coords.size() == serial->texture_coords.size());
+    REQUIRE(parallel->normals.size() == serial->normals.size());
+    REQUIRE(vec_almost_equal(parallel->positions.back(), serial->positions.back()));
+    REQUIRE(vec_almost_equal(parallel->normals.back(), serial->normals.back()));
+  }
+
+  SECTION("error_in_later_chunk") {
+    REQUIRE(!test.parse_chunks(file_contents + "v 1.0 asd 2.0\n", 4));
+    REQUIRE(!test.parse_chunks("f 1 2 3\nv 1 2 3\nv a\n" + file_contents, 4));
+  }
+}
+
+TEST_CASE("count_elements_matches_parse", "[count_elements]") {
+  ObjParserTest test;
+  const std::string file_contents =
+      R"(# comment with v 1 2 3
+v 12.0 11.23 32.42
+vt 0.23 0.34
+vn 1.01 2.12 0.12
+v 1.12 1.233 12.76
+v 1.0 2.0 3.0
+vp 1.0 2.0
+v 3.0 2.0 1.0
+f 1/1/1 2/1/1 3/1/1
+f   1//1  2//1 3//1 4//1
+usemtl material
+f 1 2 3 4 1 2)";
+
+  const auto size   = ObjParser::count_elements(file_contents);
+  const auto result = test.parse_buffer(file_contents);
+
+  REQUIRE(result);
+  REQUIRE(size.positions == result->positions.size());
+  REQUIRE(size.texture_coords == result->texture_coords.size());
+  REQUIRE(size.normals == result->normals.size());
+  REQUIRE(size.triangular_faces == result->triangular_faces.size());
+
+  // Reserved exactly, so the vectors never had to grow
+  REQUIRE(result->positions.capacity() == result->positions.size());
+  REQUIRE(result->triangular_faces.capacity() == result->triangular_faces.size());
+}
+
+TEST_CASE("skipped_attributes", "[parse_buffer]") {
+  ObjParserTest test;
+  std::string file_contents;
+  for (int i = 0; i < 50; ++i) {
+    const std::string n = std::to_string(i);
+    file_contents += "v " + n + ".5 1.0 -" + n + "\nvt 0." + n + " 0.5\nvn 0.0 1.0 0." + n + "\n";
+    if (i >= 2) {
+      file_contents += "f -1/-1/-1 -2/1/-2 -3/-3/" + n + "\n";
+    }
+  }
+
+  const auto full = test.parse_buffer(file_contents);
+  REQUIRE(full);
+
+  for (const ModelAttributes attributes : {ModelAttributes{false, false}, ModelAttributes{false, true}}) {
+    test.set_required_attributes(attributes);
+
+    for (std::size_t num_chunks : {1, 3}) {
+      const auto result = test.parse_chunks(file_contents, num_chunks);
+      REQUIRE(result);
+      REQUIRE(result->positions.size() == full->positions.size());
+      REQUIRE(result->texture_coords.empty());
+      REQUIRE(result->normals.size() == (attributes.normals ? full->normals.size() : 0));
+      REQUIRE(result->triangular_faces.size() == full->triangular_faces.size());
+
+      for (std::size_t face = 0; face < result->triangular_faces.size(); ++face) {
+        for (std::size_t corner = 0; corner < 3; ++corner) {
+          const glm::ivec3& vertex   = result->triangular_faces[face][corner];
+          const glm::ivec3& expected = full->triangular_faces[face][corner];
+
+          REQUIRE(vertex.x == expected.x);
+          REQUIRE(vertex.y == -1);
+          REQUIRE(vertex.z == (attributes.normals ? expected.z : -1));
+        }
+      }
+    }
+  }
+
+  SECTION("skipped_lines_are_not_read") {
+    test.set_required_attributes({false, false});
+    REQUIRE(test.parse_buffer("v 1 2 3\nvt asd\nvn 1\nf 1/1/1 1/1/1 1/1/1\n"));
+  }
+}
+
+TEST_CASE("feed_in_pieces", "[feed]") {
+  const std::string file_contents =
+      R"(v 12.0 11.23 32.42
+vt 0.23 0.34
+vn 1.01 2.12 0.12
+
+v 1.12 1.233 12.76
+v 1.0 2.0 3.0
+f 1/1/1 2/1/1 -1/1/1
+f 3/1/1 2/1/1 1/1/1 3/1/1)";
+
+  ObjParser whole_parser;
+  REQUIRE(whole_parser.feed(file_contents));
+  const auto expected = whole_parser.finish();
+  REQUIRE(expected);
+  REQUIRE(expected->positions.size() == 3);
+  REQUIRE(expected->triangular_faces.size() == 3);
+
+  ObjParser parser;
+
+  // Every piece size, so lines are split at every possible position
+  for (std::size_t piece_size = 1; piece_size <= file_contents.size(); ++piece_size) {
+    for (std::size_t i = 0; i < file_contents.size(); i += piece_size) {
+      REQUIRE(parser.feed(std::string_view{file_contents}.substr(i, piece_size)));
+    }
+
+    const auto result = parser.finish();
+    REQUIRE(result);
+    REQUIRE(result->triangular_faces == expected->triangular_faces);
+    REQUIRE(result->positions.size() == expected->positions.size());
+    REQUIRE(vec_almost_equal(result->positions[1], expected->positions[1]));
+    REQUIRE(vec_almost_equal(result->normals[0], expected->normals[0]));
+  }
+
+  SECTION("error_stops_feeding") {
+    REQUIRE(parser.feed("v 1.0 2.0 3.0\nv 1.0 2"));
+    REQUIRE(!parser.feed(".0 asd\nv 1 2 3\n"));
+    REQUIRE(!parser.feed("v 1 2 3\n"));
+    REQUIRE(!parser.finish());
+
+    // finish resets the parser
+    REQUIRE(parser.feed("v 1 2 3"));
+    const auto result = parser.finish();
+    REQUIRE(result);
+    REQUIRE(result->positions.size() == 1);
+  }
+
+  SECTION("error_in_last_line") {
+    REQUIRE(parser.feed("v 1.0 2.0 3.0\nv 1.0"));
+    REQUIRE(!parser.finish());
+  }
+}
+
 TEST_CASE("correct_faces", "[process_faces]") {
   ObjParserTest test;
 
@@ -207,6 +444,18 @@ TEST_CASE("incorrect_faces", "[process_faces]") {
     REQUIRE(!result);
   }
 
+  SECTION("junk_after_index") {
+    const std::string faces = "1/2/3 7a/9/3 2/3/9";
+    const auto result       = test.process_faces(faces);
+    REQUIRE(!result);
+  }
+
+  SECTION("too_many_slashes") {
+    const std::string faces = "1/2/3/4 7/9/3 2/3/9";
+    const auto result       = test.process_faces(faces);
+    REQUIRE(!result);
+  }
+
   SECTION("different_format") {
     const std::string faces = "23/2/3 423/9/ 53//9";
     const auto result       = test.process_faces(faces);
@@ -0,0 +1,72 @@
+#include <cstdio>
+#include <string>
+
+#include "catch/catch.hpp"
+
+#include "FileHelper.hpp"
+#include "ObjParser.hpp"
+#include "ObjPrinter.hpp"
+
+TEST_CASE("obj_lines", "[ObjPrinter]") {
+  Model model{0};
+  model.positions      = {{0, 0, 0, 1}, {2.5, 0, 0, 0.5}, {0, -0.1f, 1e-20f, 1}};
+  model.texture_coords = {{0.5, 0, 0}, {0.5, 0.25, 0}, {0, 0, 1}};
+  model.normals        = {{0, 0, 1}};
+  model.triangular_faces.push_back({glm::ivec3{0, -1, -1}, glm::ivec3{1, -1, -1}, glm::ivec3{2, -1, -1}});
+  model.triangular_faces.push_back({glm::ivec3{0, 1, -1}, glm::ivec3{1, 1, -1}, glm::ivec3{2, 0, -1}});
+  model.triangular_faces.push_back({glm::ivec3{0, -1, 0}, glm::ivec3{1, -1, 0}, glm::ivec3{2, -1, 0}});
+  model.triangular_faces.push_back({glm::ivec3{2, 2, 0}, glm::ivec3{1, 0, 0}, glm::ivec3{0, 1, 0}});
+
+  ObjPrinter printer;
+  REQUIRE(printer.print(model, "obj_printer_test.obj"));
+  REQUIRE(read_file("obj_printer_test.obj") ==
+          "v 0 0 0\n"
+          "v 2.5 0 0 0.5\n"
+          "v 0 -0.1 1e-20\n"
+          "vt 0.5\n"
+          "vt 0.5 0.25\n"
+          "vt 0 0 1\n"
+          "vn 0 0 1\n"
+          "f 1 2 3\n"
+          "f 1/2 2/2 3/1\n"
+          "f 1//1 2//1 3//1\n"
+          "f 3/3/1 2/1/1 1/2/1\n");
+
+  std::remove("obj_printer_test.obj");
+}
+
+TEST_CASE("obj_round_trip", "[ObjPrinter]") {
+  // More than one chunk of every kind of line
+  Model model{0};
+  for (int i = 0; i < 70000; ++i) {
+    model.positions.push_back({i / 7.0f, -i / 3.0f, 1.0f / (i + 1), 1});
+    model.texture_coords.push_back({i / 70000.0f, 0.5f, 0});
+    model.normals.push_back({0, i / 11.0f, 1});
+  }
+  // Every kind of vertex: position only, with texture, with normal and with both
+  for (int i = 0; i + 2 < 70000; ++i) {
+    const int texture = i % 4 < 2 ? i : -1;
+    const int normal  = i % 2 == 0 ? i : -1;
+    model.triangular_faces.push_back(
+        {glm::ivec3{i, texture, normal}, glm::ivec3{i + 1, texture, normal}, glm::ivec3{i + 2, texture, normal}});
+  }
+
+  ObjPrinter printer;
+  printer.set_num_threads(1);
+  REQUIRE(printer.print(model, "obj_serial.obj"));
+  printer.set_num_threads(3);
+  REQUIRE(printer.print(model, "obj_parallel.obj"));
+
+  REQUIRE(read_file("obj_parallel.obj") == read_file("obj_serial.obj"));
+
+  ObjParser parser;
+  const auto parsed = parser.parse("obj_parallel.obj");
+  REQUIRE(parsed);
+  REQUIRE(parsed->positions == model.positions);
+  REQUIRE(parsed->texture_coords == model.texture_coords);
+  REQUIRE(parsed->normals == model.normals);
+  REQUIRE(parsed->triangular_faces == model.triangular_faces);
+
+  std::remove("obj_serial.obj");
+  std::remove("obj_parallel.obj");
+}
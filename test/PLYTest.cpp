@@ -0,0 +1,149 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "catch/catch.hpp"
+
+#include "FileHelper.hpp"
+#include "PLYParser.hpp"
+#include "PLYPrinter.hpp"
+
+namespace {
+class PLYParserTest : public PLYParser {
+ public:
+  using PLYParser::parse_buffer;
+};
+
+}  // namespace
+
+TEST_CASE("ply_round_trip", "[PLY]") {
+  Model model{0};
+  for (int i = 0; i < 100000; ++i) {
+    model.positions.push_back({i / 7.0f, -i / 3.0f, 1.0f / (i + 1), 1});
+  }
+  for (int i = 0; i + 2 < 100000; ++i) {
+    model.triangular_faces.push_back({glm::ivec3{i, -1, -1}, glm::ivec3{i + 2, -1, -1}, glm::ivec3{i + 1, -1, -1}});
+  }
+
+  PLYPrinter printer;
+  REQUIRE(printer.print(model, "ply_test.ply"));
+
+  const std::string file = read_file("ply_test.ply");
+  REQUIRE(file.size() > 12 * model.positions.size() + 13 * model.triangular_faces.size());
+  REQUIRE(file.size() < 12 * model.positions.size() + 13 * model.triangular_faces.size() + 300);
+
+  // Memory mapped and through a stream
+  PLYParser parser;
+  for (const auto& parsed : {parser.parse("ply_test.ply"), PLYParserTest().parse_buffer(file)}) {
+    REQUIRE(parsed);
+    REQUIRE(parsed->positions == model.positions);
+    REQUIRE(parsed->triangular_faces == model.triangular_faces);
+    REQUIRE(parsed->normals.empty());
+    REQUIRE(parsed->texture_coords.empty());
+  }
+
+  std::remove("ply_test.ply");
+}
+
+TEST_CASE("ply_general_layout", "[PLY]") {
+  // Doubles with normals and an extra property, a quad with a ushort count next to a face property, and an element
+  // nobody reads before the faces
+  std::string data =
+      "ply\r\n"
+      "format binary_little_endian 1.0\r\n"
+      "comment made by hand\r\n"
+      "element vertex 4\r\n"
+      "property double x\r\n"
+      "property double y\r\n"
+      "property double z\r\n"
+      "property uchar red\r\n"
+      "property float nx\r\n"
+      "property float ny\r\n"
+      "property float nz\r\n"
+      "element edge 2\r\n"
+      "property list uchar int vertices\r\n"
+      "element face 2\r\n"
+      "property uchar flags\r\n"
+      "property list ushort uint vertex_index\r\n"
+      "end_header\r\n";
+
+  for (int i = 0; i < 4; ++i) {
+    append_binary<double>(data, i);
+    append_binary<double>(data, i * 2);
+    append_binary<double>(data, 0.5);
+    append_binary<std::uint8_t>(data, 255);
+    append_binary<float>(data, 0);
+    append_binary<float>(data, 0);
+    append_binary<float>(data, 1);
+  }
+  for (int i = 0; i < 2; ++i) {
+    append_binary<std::uint8_t>(data, 2);
+    append_binary<std::int32_t>(data, i);
+    append_binary<std::int32_t>(data, i + 1);
+  }
+  append_binary<std::uint8_t>(data, 7);
+  append_binary<std::uint16_t>(data, 4);
+  for (std::uint32_t index : {0, 1, 2, 3}) {
+    append_binary<std::uint32_t>(data, index);
+  }
+  append_binary<std::uint8_t>(data, 7);
+  append_binary<std::uint16_t>(data, 3);
+  for (std::uint32_t index : {3, 2, 1}) {
+    append_binary<std::uint32_t>(data, index);
+  }
+
+  PLYParserTest parser;
+
+  SECTION("all_attributes") {
+    const auto parsed = parser.parse_buffer(data);
+    REQUIRE(parsed);
+    REQUIRE(parsed->positions.size() == 4);
+    REQUIRE(parsed->positions[3] == glm::vec4{3, 6, 0.5, 1});
+    REQUIRE(parsed->normals.size() == 4);
+    REQUIRE(parsed->normals[2] == glm::vec3{0, 0, 1});
+    REQUIRE(parsed->triangular_faces.size() == 3);
+    REQUIRE(parsed->triangular_faces[1][2] == glm::ivec3{3, -1, 3});
+    REQUIRE(parsed->triangular_faces[2][0] == glm::ivec3{3, -1, 3});
+  }
+
+  SECTION("skipped_normals") {
+    parser.set_required_attributes({false, false});
+    const auto parsed = parser.parse_buffer(data);
+    REQUIRE(parsed);
+    REQUIRE(parsed->normals.empty());
+    REQUIRE(parsed->triangular_faces[1][2] == glm::ivec3{3, -1, -1});
+  }
+
+  SECTION("truncated") { REQUIRE(!parser.parse_buffer(data.substr(0, data.size() - 1))); }
+
+  SECTION("oversized_counts") {
+    for (const auto* element : {"element vertex 4\r", "element face 2\r"}) {
+      std::string corrupt = data;
+      const std::size_t count = corrupt.find(element) + std::strlen(element) - 2;
+      REQUIRE(!parser.parse_buffer(corrupt.replace(count, 1, "100000000000000")));
+    }
+  }
+
+  SECTION("index_out_of_range") {
+    data[data.size() - 4] = 4;
+    REQUIRE(!parser.parse_buffer(data));
+  }
+
+  SECTION("unsupported_format") {
+    const std::size_t format = data.find("binary_little_endian");
+    REQUIRE(!parser.parse_buffer(data.replace(format, 20, "ascii")));
+  }
+
+  SECTION("end_header_in_comment") {
+    const std::size_t comment = data.find("made by hand");
+    REQUIRE(parser.parse_buffer(data.replace(comment, 12, "before end_header")));
+  }
+
+  SECTION("header_without_end") { REQUIRE(!parser.parse_buffer(data.substr(0, data.find("end_header")))); }
+
+  SECTION("not_ply") {
+    REQUIRE(!parser.parse_buffer("v 1 2 3\n"));
+    REQUIRE(!parser.parse_buffer("plyx\nend_header\n"));
+  }
+}
@@ -0,0 +1,121 @@
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "catch/catch.hpp"
+
+#include "FileHelper.hpp"
+#include "STLParser.hpp"
+#include "STLPrinter.hpp"
+
+namespace {
+class STLParserTest : public STLParser {
+ public:
+  using STLParser::parse_buffer;
+};
+
+std::string make_stl(const std::vector<std::array<float, 12>>& triangles) {
+  std::string data(80, ' ');
+  append_binary(data, static_cast<std::uint32_t>(triangles.size()));
+
+  for (const auto& triangle : triangles) {
+    for (float value : triangle) {
+      append_binary(data, value);
+    }
+    append_binary(data, std::uint16_t{0});
+  }
+
+  return data;
+}
+}  // namespace
+
+TEST_CASE("stl_welds_vertices", "[STLParser]") {
+  // Grid of quads, the vertices are numbered in the order they first appear in the triangles
+  const int size = 300;
+  Model model{0};
+  std::vector<int> indices((size + 1) * (size + 1), -1);
+  const auto index = [&](int x, int y) {
+    int& result = indices[y * (size + 1) + x];
+    if (result == -1) {
+      result = static_cast<int>(model.positions.size());
+      model.positions.push_back({x * 0.5f, y * 0.25f, (x * y) % 7 * 1.0f, 1.0f});
+    }
+    return glm::ivec3{result, -1, -1};
+  };
+
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      const auto a = index(x, y), b = index(x + 1, y), c = index(x + 1, y + 1), d = index(x, y + 1);
+      model.triangular_faces.push_back({a, b, c});
+      model.triangular_faces.push_back({a, c, d});
+    }
+  }
+
+  STLPrinter printer;
+  REQUIRE(printer.print(model, "stl_parser_test.stl"));
+
+  for (std::size_t num_threads : {1, 4}) {
+    STLParser parser;
+    parser.set_num_threads(num_threads);
+    const auto parsed = parser.parse("stl_parser_test.stl");
+    REQUIRE(parsed);
+
+    REQUIRE(parsed->positions == model.positions);
+    REQUIRE(parsed->triangular_faces.size() == model.triangular_faces.size());
+    REQUIRE(parsed->normals.size() == model.triangular_faces.size());
+
+    for (std::size_t i = 0; i < model.triangular_faces.size(); ++i) {
+      for (int corner = 0; corner < 3; ++corner) {
+        REQUIRE(parsed->triangular_faces[i][corner] ==
+                glm::ivec3{model.triangular_faces[i][corner].x, -1, static_cast<int>(i)});
+      }
+    }
+  }
+
+  std::remove("stl_parser_test.stl");
+}
+
+TEST_CASE("stl_negative_zero", "[STLParser]") {
+  STLParserTest parser;
+  const auto model = parser.parse_buffer(make_stl({
+      {0, 0, 1, 0.0f, 0.0f, 0.0f, 1, 0, 0, 0, 1, 0},
+      {0, 0, 1, -0.0f, 0.0f, -0.0f, 0, 1, 0, 1, 0, 0},
+  }));
+  REQUIRE(model);
+
+  REQUIRE(model->positions.size() == 3);
+  REQUIRE(model->positions[0] == glm::vec4{0, 0, 0, 1});
+  REQUIRE(!std::signbit(model->positions[0].x));
+  REQUIRE(model->triangular_faces[1][0].x == 0);
+  REQUIRE(model->triangular_faces[1][1].x == 2);
+  REQUIRE(model->triangular_faces[1][2].x == 1);
+  REQUIRE(model->normals[1] == glm::vec3{0, 0, 1});
+}
+
+TEST_CASE("stl_skipped_normals", "[STLParser]") {
+  STLParserTest parser;
+  parser.set_required_attributes({false, false});
+  const auto model = parser.parse_buffer(make_stl({{0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0}}));
+  REQUIRE(model);
+
+  REQUIRE(model->normals.empty());
+  REQUIRE(model->triangular_faces[0][2] == glm::ivec3{2, -1, -1});
+}
+
+TEST_CASE("stl_invalid_files", "[STLParser]") {
+  STLParserTest parser;
+  REQUIRE(!parser.parse_buffer(std::string(50, ' ')));
+
+  std::string truncated = make_stl({{0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0}});
+  truncated.pop_back();
+  REQUIRE(!parser.parse_buffer(truncated));
+
+  REQUIRE(!parser.parse_buffer("solid cube\nfacet normal 0 0 1\nouter loop\nvertex 0 0 0\n" + std::string(80, ' ')));
+
+  const auto empty = parser.parse_buffer(make_stl({}));
+  REQUIRE(empty);
+  REQUIRE(empty->positions.empty());
+}
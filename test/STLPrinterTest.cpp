@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "catch/catch.hpp"
+
+#include "FileHelper.hpp"
+#include "STLPrinter.hpp"
+
+TEST_CASE("parallel_print", "[STLPrinter]") {
+  // Enough triangles for several blocks, with and without normals
+  Model model{0};
+  model.normals = {{0, 0, 1}, {0, 1, 0}};
+  for (int i = 0; i < 100000; ++i) {
+    model.positions.push_back({i, 2 * i, 0.5f * i, 1});
+  }
+  for (int i = 0; i + 2 < 100000; ++i) {
+    model.triangular_faces.push_back(
+        {glm::ivec3{i, -1, i % 3 - 1}, glm::ivec3{i + 1, -1, 0}, glm::ivec3{i + 2, -1, 0}});
+  }
+
+  STLPrinter printer;
+
+  printer.set_num_threads(1);
+  REQUIRE(printer.print(model, "parallel_print_serial.stl"));
+  printer.set_num_threads(4);
+  REQUIRE(printer.print(model, "parallel_print_parallel.stl"));
+
+  const std::string serial = read_file("parallel_print_serial.stl");
+  REQUIRE(serial.size() == 84 + 50 * model.triangular_faces.size());
+  REQUIRE(read_file("parallel_print_parallel.stl") == serial);
+
+  uint32_t num_of_faces = 0;
+  std::memcpy(&num_of_faces, serial.data() + 80, sizeof(num_of_faces));
+  REQUIRE(num_of_faces == model.triangular_faces.size());
+
+  SECTION("overwrites_larger_file") {
+    model.triangular_faces.resize(50000);
+    REQUIRE(printer.print(model, "parallel_print_parallel.stl"));
+    // 50000 = 0xc350 triangles, the rest of the file is the beginning of the previous one
+    const std::string expected = serial.substr(0, 84 + 50 * 50000).replace(80, 4, "\x50\xc3\0\0", 4);
+    REQUIRE(read_file("parallel_print_parallel.stl") == expected);
+  }
+
+  std::remove("parallel_print_serial.stl");
+  std::remove("parallel_print_parallel.stl");
+}
+
+TEST_CASE("normals", "[STLPrinter]") {
+  Model model{0};
+  model.positions = {{0, 0, 0, 1}, {2, 0, 0, 1}, {0, 2, 0, 1}};
+  model.triangular_faces.push_back({glm::ivec3{0, -1, 0}, glm::ivec3{1, -1, 0}, glm::ivec3{2, -1, 0}});
+
+  const auto printed_normal = [&model](STLPrinter& printer) {
+    REQUIRE(printer.print(model, "normals_test.stl"));
+    const std::string stl = read_file("normals_test.stl");
+    std::remove("normals_test.stl");
+
+    glm::vec3 normal;
+    std::memcpy(&normal.x, stl.data() + 84, sizeof(float));
+    std::memcpy(&normal.y, stl.data() + 88, sizeof(float));
+    std::memcpy(&normal.z, stl.data() + 92, sizeof(float));
+    return normal;
+  };
+
+  STLPrinter printer;
+
+  SECTION("missing_normals") { REQUIRE(printed_normal(printer) == glm::vec3{0, 0, 1}); }
+
+  SECTION("stored_normals") {
+    model.normals.push_back({1, 0, 0});
+    REQUIRE(printed_normal(printer) == glm::vec3{1, 0, 0});
+
+    printer.set_recompute_normals(true);
+    REQUIRE(!printer.required_attributes().normals);
+    REQUIRE(printed_normal(printer) == glm::vec3{0, 0, 1});
+  }
+}
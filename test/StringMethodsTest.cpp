@@ -1,3 +1,4 @@
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -93,6 +94,72 @@ TEST_CASE("real_example", "[split_at_trim_separators]") {
   REQUIRE(std::vector<std::string>{"1/2/8", "2/4/5"} == split_at_trim_separators(text, ' '));
 }
 
+TEST_CASE("split_view_tokens", "[SplitView]") {
+  using Tokens = std::vector<std::string>;
+  struct Case {
+    std::string text;
+    char separator;
+    Tokens tokens;
+    Tokens trimmed_tokens;
+  };
+
+  const std::vector<Case> cases = {
+      {"", '/', {}, {}},
+      {"a", '/', {"a"}, {"a"}},
+      {"/", '/', {"", ""}, {}},
+      {"//", '/', {"", "", ""}, {}},
+      {"a///b", '/', {"a", "", "", "b"}, {"a", "b"}},
+      {"4.23/1.232/", '/', {"4.23", "1.232", ""}, {"4.23", "1.232"}},
+      {"/4.23/1.232/", '/', {"", "4.23", "1.232", ""}, {"4.23", "1.232"}},
+      {"comma,separated,text", ',', {"comma", "separated", "text"}, {"comma", "separated", "text"}},
+      {"comma,separated,text", ' ', {"comma,separated,text"}, {"comma,separated,text"}},
+      {" 23  42 ", ' ', {"", "23", "", "42", ""}, {"23", "42"}},
+      // Longer than a vector block of the scanner
+      {std::string(40, ' ') + "1/2/3" + std::string(40, ' ') + "4",
+       ' ',
+       [] {
+         Tokens tokens(40, "");
+         tokens.push_back("1/2/3");
+         tokens.insert(tokens.end(), 39, "");
+         tokens.push_back("4");
+         return tokens;
+       }(),
+       {"1/2/3", "4"}},
+  };
+
+  for (const auto& test_case : cases) {
+    Tokens tokens;
+    for (const auto& token : SplitView{test_case.text, test_case.separator}) {
+      tokens.emplace_back(token);
+    }
+
+    Tokens trimmed_tokens;
+    for (const auto& token : SplitView{test_case.text, test_case.separator, true}) {
+      trimmed_tokens.emplace_back(token);
+    }
+
+    INFO("\"" << test_case.text << "\" split at '" << test_case.separator << "'");
+    REQUIRE(tokens == test_case.tokens);
+    REQUIRE(split_at(test_case.text, test_case.separator) == test_case.tokens);
+    REQUIRE(trimmed_tokens == test_case.trimmed_tokens);
+    REQUIRE(split_at_trim_separators(test_case.text, test_case.separator) == test_case.trimmed_tokens);
+  }
+}
+
+TEST_CASE("split_view_points_into_text", "[SplitView]") {
+  const std::string text = "  1/2/3   4/5/6 ";
+  const SplitView view{text, ' ', true};
+
+  auto it = view.begin();
+  REQUIRE(*it == "1/2/3");
+  REQUIRE(it->data() == text.data() + 2);
+  ++it;
+  REQUIRE(*it == "4/5/6");
+  REQUIRE(it->data() == text.data() + 10);
+  ++it;
+  REQUIRE(it == view.end());
+}
+
 TEST_CASE("successful_get_number_from_string", "[get_number_from_string]") {
   SECTION("regular_number_with_whitespaces") {
     const std::string str_to_process{"    3.1415"};
@@ -122,7 +189,69 @@ TEST_CASE("successful_get_number_from_string", "[get_number_from_string]") {
   }
 }
 
+TEST_CASE("get_number_from_string_round_trip", "[get_number_from_string]") {
+  SECTION("float_rounded_once") {
+    // Rounding through double first would give a different float for this input
+    const std::string str_to_process{"1.00000005960464477550"};
+    auto result = get_number_from_string<float>(str_to_process);
+
+    REQUIRE(result);
+    REQUIRE(result->first == 1.00000011920928955078125f);
+  }
+
+  SECTION("float_out_of_range") {
+    // Narrowed like std::stod and a cast: too small values become 0, too large ones infinity
+    auto tiny = get_number_from_string<float>("1e-50 2");
+    REQUIRE(tiny);
+    REQUIRE(tiny->first == 0.0f);
+    REQUIRE(tiny->second == 5);
+
+    auto huge = get_number_from_string<float>("1e39");
+    REQUIRE(huge);
+    REQUIRE(huge->first == std::numeric_limits<float>::infinity());
+
+    auto negative_huge = get_number_from_string<float>("-1e39");
+    REQUIRE(negative_huge);
+    REQUIRE(negative_huge->first == -std::numeric_limits<float>::infinity());
+
+    // Out of the range of double too, std::stod rejected it as well
+    REQUIRE(!get_number_from_string<float>("1e400"));
+  }
+
+  SECTION("plus_sign") {
+    auto result = get_number_from_string<int>(" +42");
+
+    REQUIRE(result);
+    REQUIRE(result->first == 42);
+    REQUIRE(result->second == 4);
+  }
+
+  SECTION("exponent") {
+    auto result = get_number_from_string<double>("-1.5e-3 2");
+
+    REQUIRE(result);
+    REQUIRE(result->first == -1.5e-3);
+    REQUIRE(result->second == 7);
+  }
+
+  SECTION("integer_stops_at_non_digit") {
+    auto result = get_number_from_string<int>("12/34");
+
+    REQUIRE(result);
+    REQUIRE(result->first == 12);
+    REQUIRE(result->second == 2);
+  }
+}
+
 TEST_CASE("unsuccessful_get_number_from_string", "[get_number_from_string]") {
+  SECTION("empty") { REQUIRE(!get_number_from_string<double>("")); }
+
+  SECTION("only_whitespaces") { REQUIRE(!get_number_from_string<double>("   ")); }
+
+  SECTION("two_signs") { REQUIRE(!get_number_from_string<int>("+-3")); }
+
+  SECTION("out_of_range") { REQUIRE(!get_number_from_string<int>("99999999999999999999")); }
+
   SECTION("character_with_whitespaces") {
     const std::string str_to_process{"    a.1415"};
     auto result = get_number_from_string<double>(str_to_process);
@@ -0,0 +1,98 @@
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch/catch.hpp"
+
+#include "StructuralScanner.hpp"
+
+namespace {
+std::string random_obj_like_text(const std::size_t size) {
+  const std::string alphabet = "0123456789.- /\nvft";
+  std::mt19937 generator{7};
+  std::uniform_int_distribution<std::size_t> distribution{0, alphabet.size() - 1};
+
+  std::string text(size, ' ');
+  for (auto& ch : text) {
+    ch = alphabet[distribution(generator)];
+  }
+
+  return text;
+}
+
+std::vector<std::string> getline_lines(const std::string& text) {
+  std::vector<std::string> lines;
+  std::istringstream in{text};
+  for (std::string line; std::getline(in, line);) {
+    lines.push_back(line);
+  }
+
+  return lines;
+}
+
+std::vector<std::string> scanned_lines(const std::string& text, const StructuralScanner& scanner) {
+  std::vector<std::string> lines;
+  LineScanner line_scanner{text, scanner};
+  for (std::string_view line; line_scanner.next(line);) {
+    lines.emplace_back(line);
+  }
+
+  return lines;
+}
+}  // namespace
+
+TEST_CASE("levels_match_scalar", "[StructuralScanner]") {
+  const StructuralScanner scalar{StructuralScanner::Level::scalar};
+  const std::string text = random_obj_like_text(1000);
+
+  for (const auto level : {StructuralScanner::Level::sse2, StructuralScanner::Level::avx2}) {
+    const StructuralScanner scanner{level};
+
+    for (const char ch : {' ', '/', '\n', 'x'}) {
+      // Every start and length, so all the block sizes and tails are covered
+      for (std::size_t first = 0; first < 100; ++first) {
+        for (std::size_t length = 0; length < 100; ++length) {
+          const char* begin = text.data() + first;
+          const char* end   = begin + length;
+
+          REQUIRE(scanner.find(begin, end, ch) == scalar.find(begin, end, ch));
+          REQUIRE(scanner.find_not(begin, end, ch) == scalar.find_not(begin, end, ch));
+        }
+      }
+
+      for (std::size_t offset = 0; offset + 64 <= text.size(); offset += 37) {
+        REQUIRE(scanner.match_64(text.data() + offset, ch) == scalar.match_64(text.data() + offset, ch));
+      }
+    }
+  }
+}
+
+TEST_CASE("find_not_runs_of_separators", "[StructuralScanner]") {
+  const std::string text = std::string(70, ' ') + "1/2/3";
+  const StructuralScanner& scanner = StructuralScanner::best();
+
+  REQUIRE(scanner.find_not(text.data(), text.data() + text.size(), ' ') == text.data() + 70);
+  REQUIRE(scanner.find(text.data(), text.data() + text.size(), '/') == text.data() + 71);
+  REQUIRE(scanner.find(text.data(), text.data() + 70, '/') == text.data() + 70);
+}
+
+TEST_CASE("lines_match_getline", "[LineScanner]") {
+  const std::vector<std::string> texts = {"",
+                                          "\n",
+                                          "\n\n",
+                                          "no newline",
+                                          "v 1 2 3\n",
+                                          "v 1 2 3\nf 1 2 3",
+                                          std::string(63, 'a') + "\n" + std::string(64, 'b') + "\n\nc",
+                                          random_obj_like_text(5000)};
+
+  for (const auto level :
+       {StructuralScanner::Level::scalar, StructuralScanner::Level::sse2, StructuralScanner::Level::avx2}) {
+    const StructuralScanner scanner{level};
+
+    for (const auto& text : texts) {
+      REQUIRE(scanned_lines(text, scanner) == getline_lines(text));
+    }
+  }
+}
@@ -0,0 +1,81 @@
+#include <random>
+#include <vector>
+
+#include "catch/catch.hpp"
+
+#include "Weld.hpp"
+
+namespace {
+// Soup of the triangles of a grid, every corner is a separate position moved by at most noise
+Model generate_soup(int side, float noise) {
+  std::mt19937 generator{7};
+  std::uniform_real_distribution<float> offset{-noise, noise};
+
+  Model model{0};
+  const auto corner = [&](int x, int y) {
+    model.positions.push_back({x + offset(generator), y + offset(generator), offset(generator), 1});
+    return glm::ivec3{static_cast<int>(model.positions.size()) - 1, -1, -1};
+  };
+
+  for (int y = 0; y + 1 < side; ++y) {
+    for (int x = 0; x + 1 < side; ++x) {
+      model.triangular_faces.push_back({corner(x, y), corner(x + 1, y), corner(x + 1, y + 1)});
+      model.triangular_faces.push_back({corner(x, y), corner(x + 1, y + 1), corner(x, y + 1)});
+    }
+  }
+
+  return model;
+}
+}  // namespace
+
+TEST_CASE("weld_soup", "[Weld]") {
+  const int side     = 200;
+  const Model source = generate_soup(side, 0.001f);
+
+  Model single_threaded = source;
+  REQUIRE(weld_positions(single_threaded, 0.01f, 1) == source.positions.size() - side * side);
+  REQUIRE(single_threaded.positions.size() == side * side);
+
+  // Kept positions are the first occurrences, in order
+  REQUIRE(single_threaded.positions[0] == source.positions[0]);
+  REQUIRE(single_threaded.positions[1] == source.positions[1]);
+
+  for (std::size_t face = 0; face < source.triangular_faces.size(); ++face) {
+    for (int corner = 0; corner < 3; ++corner) {
+      const glm::vec4 before = source.positions[source.triangular_faces[face][corner].x];
+      const glm::vec4 after  = single_threaded.positions[single_threaded.triangular_faces[face][corner].x];
+      REQUIRE(glm::length(glm::vec3{before} - glm::vec3{after}) < 0.01f);
+    }
+  }
+
+  Model multi_threaded = source;
+  weld_positions(multi_threaded, 0.01f, 4);
+  REQUIRE(multi_threaded.positions == single_threaded.positions);
+  REQUIRE(multi_threaded.triangular_faces == single_threaded.triangular_faces);
+
+  // Nothing is within a too small epsilon
+  Model unchanged = source;
+  REQUIRE(weld_positions(unchanged, 1e-7f) == 0);
+  REQUIRE(unchanged.positions == source.positions);
+  REQUIRE(unchanged.triangular_faces == source.triangular_faces);
+}
+
+TEST_CASE("weld_exact_and_chains", "[Weld]") {
+  Model model{0};
+  model.positions = {{0, 0, 0, 1}, {-0.0f, 0, 0, 1}, {1, 0, 0, 1}, {1.5f, 0, 0, 1}, {2, 0, 0, 1}, {0, 1, 0, 1}};
+  model.triangular_faces = {{glm::ivec3{1, 0, 0}, glm::ivec3{4, -1, 0}, glm::ivec3{5, 2, -1}}};
+
+  Model exact = model;
+  REQUIRE(weld_positions(exact, 0) == 1);
+  REQUIRE(exact.positions.size() == 5);
+  REQUIRE(exact.triangular_faces[0][0] == glm::ivec3{0, 0, 0});
+  REQUIRE(exact.triangular_faces[0][1] == glm::ivec3{3, -1, 0});
+
+  // 1, 1.5 and 2 form a chain, the ends are merged too although they are further apart than epsilon
+  Model chained = model;
+  REQUIRE(weld_positions(chained, 0.6f) == 3);
+  REQUIRE(chained.positions == std::vector<glm::vec4>{{0, 0, 0, 1}, {1, 0, 0, 1}, {0, 1, 0, 1}});
+  REQUIRE(chained.triangular_faces[0][0] == glm::ivec3{0, 0, 0});
+  REQUIRE(chained.triangular_faces[0][1] == glm::ivec3{1, -1, 0});
+  REQUIRE(chained.triangular_faces[0][2] == glm::ivec3{2, 2, -1});
+}